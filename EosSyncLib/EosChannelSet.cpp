@@ -0,0 +1,518 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosChannelSet.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#define EOS_CHANNEL_SET_MSVC_64
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChannelSet::operator==(const EosChannelSet &other) const
+{
+  if (m_NumChannels != other.m_NumChannels || m_Runs.size() != other.m_Runs.size())
+    return false;
+
+  for (size_t i = 0; i < m_Runs.size(); i++)
+  {
+    if (m_Runs[i].first != other.m_Runs[i].first || m_Runs[i].last != other.m_Runs[i].last)
+      return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelSet::Clear()
+{
+  m_Runs.clear();
+  m_NumChannels = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelSet::AddRange(uint32_t first, uint32_t last)
+{
+  if (first > last)
+    return;
+
+  // appending in order is the common case
+  if (m_Runs.empty() || (m_Runs.back().last != UINT32_MAX && first > (m_Runs.back().last + 1)))
+  {
+    sRun run;
+    run.first = first;
+    run.last = last;
+    m_Runs.push_back(run);
+    m_NumChannels += (static_cast<size_t>(last - first) + 1);
+    return;
+  }
+
+  // first run that ends at or after first - 1, i.e. could touch the new range
+  size_t lo = 0;
+  size_t count = m_Runs.size();
+  while (count != 0)
+  {
+    size_t step = (count / 2);
+    if (m_Runs[lo + step].last != UINT32_MAX && (m_Runs[lo + step].last + 1) < first)
+    {
+      lo += (step + 1);
+      count -= (step + 1);
+    }
+    else
+      count = step;
+  }
+
+  // swallow every run that overlaps or touches the new range
+  size_t hi = lo;
+  while (hi < m_Runs.size() && (last == UINT32_MAX || m_Runs[hi].first <= (last + 1)))
+  {
+    if (m_Runs[hi].first < first)
+      first = m_Runs[hi].first;
+    if (m_Runs[hi].last > last)
+      last = m_Runs[hi].last;
+    m_NumChannels -= (static_cast<size_t>(m_Runs[hi].last - m_Runs[hi].first) + 1);
+    hi++;
+  }
+
+  sRun run;
+  run.first = first;
+  run.last = last;
+  if (lo == hi)
+    m_Runs.insert(m_Runs.begin() + lo, run);
+  else
+  {
+    m_Runs[lo] = run;
+    m_Runs.erase(m_Runs.begin() + lo + 1, m_Runs.begin() + hi);
+  }
+  m_NumChannels += (static_cast<size_t>(last - first) + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChannelSet::Contains(uint32_t channel) const
+{
+  size_t lo = 0;
+  size_t count = m_Runs.size();
+  while (count != 0)
+  {
+    size_t step = (count / 2);
+    if (m_Runs[lo + step].last < channel)
+    {
+      lo += (step + 1);
+      count -= (step + 1);
+    }
+    else
+      count = step;
+  }
+
+  return (lo < m_Runs.size() && m_Runs[lo].first <= channel);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChannelSet::Intersects(const EosChannelSet &other) const
+{
+  size_t i = 0;
+  size_t j = 0;
+  while (i < m_Runs.size() && j < other.m_Runs.size())
+  {
+    const sRun &a = m_Runs[i];
+    const sRun &b = other.m_Runs[j];
+    if (a.last < b.first)
+      i++;
+    else if (b.last < a.first)
+      j++;
+    else
+      return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelSet::GetChannels(std::vector<uint32_t> &channels) const
+{
+  channels.reserve(channels.size() + m_NumChannels);
+  for (RUNS::const_iterator i = m_Runs.begin(); i != m_Runs.end(); i++)
+  {
+    for (uint32_t channel = i->first;; channel++)
+    {
+      channels.push_back(channel);
+      if (channel == i->last)
+        break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelSet::Union(const EosChannelSet &a, const EosChannelSet &b, EosChannelSet &result)
+{
+  EosChannelSet temp;
+  temp.m_Runs.reserve(a.m_Runs.size() + b.m_Runs.size());
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.m_Runs.size() || j < b.m_Runs.size())
+  {
+    const sRun &run = ((j == b.m_Runs.size() || (i < a.m_Runs.size() && a.m_Runs[i].first < b.m_Runs[j].first)) ? a.m_Runs[i++] : b.m_Runs[j++]);
+    temp.Append(run.first, run.last);
+  }
+
+  result.m_Runs.swap(temp.m_Runs);
+  result.m_NumChannels = temp.m_NumChannels;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelSet::Intersect(const EosChannelSet &a, const EosChannelSet &b, EosChannelSet &result)
+{
+  EosChannelSet temp;
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.m_Runs.size() && j < b.m_Runs.size())
+  {
+    const sRun &x = a.m_Runs[i];
+    const sRun &y = b.m_Runs[j];
+    uint32_t first = ((x.first > y.first) ? x.first : y.first);
+    uint32_t last = ((x.last < y.last) ? x.last : y.last);
+    if (first <= last)
+      temp.Append(first, last);
+
+    if (x.last < y.last)
+      i++;
+    else
+      j++;
+  }
+
+  result.m_Runs.swap(temp.m_Runs);
+  result.m_NumChannels = temp.m_NumChannels;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelSet::Subtract(const EosChannelSet &a, const EosChannelSet &b, EosChannelSet &result)
+{
+  EosChannelSet temp;
+
+  size_t j = 0;
+  for (size_t i = 0; i < a.m_Runs.size(); i++)
+  {
+    uint64_t first = a.m_Runs[i].first;
+    uint64_t last = a.m_Runs[i].last;
+
+    // skip runs of b entirely before this one
+    while (j < b.m_Runs.size() && b.m_Runs[j].last < first)
+      j++;
+
+    // cut out every run of b that overlaps
+    for (size_t k = j; k < b.m_Runs.size() && b.m_Runs[k].first <= last && first <= last; k++)
+    {
+      if (b.m_Runs[k].first > first)
+        temp.Append(static_cast<uint32_t>(first), b.m_Runs[k].first - 1);
+      first = (static_cast<uint64_t>(b.m_Runs[k].last) + 1);
+    }
+
+    if (first <= last)
+      temp.Append(static_cast<uint32_t>(first), static_cast<uint32_t>(last));
+  }
+
+  result.m_Runs.swap(temp.m_Runs);
+  result.m_NumChannels = temp.m_NumChannels;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelSet::Append(uint32_t first, uint32_t last)
+{
+  if (!m_Runs.empty())
+  {
+    sRun &back = m_Runs.back();
+    if (back.last == UINT32_MAX || first <= (back.last + 1))
+    {
+      // overlaps or touches the last run
+      if (last > back.last)
+      {
+        m_NumChannels += (last - back.last);
+        back.last = last;
+      }
+      return;
+    }
+  }
+
+  sRun run;
+  run.first = first;
+  run.last = last;
+  m_Runs.push_back(run);
+  m_NumChannels += (static_cast<size_t>(last - first) + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChannelSet::ParseRange(const char *str, uint32_t &first, uint32_t &last)
+{
+  if (!str)
+    return false;
+
+  while (*str == ' ')
+    str++;
+
+  uint32_t n[2] = {0, 0};
+  unsigned int numCount = 0;
+  for (;;)
+  {
+    if (*str < '0' || *str > '9')
+      return false;
+
+    uint64_t value = 0;
+    for (; *str >= '0' && *str <= '9'; str++)
+    {
+      value = ((value * 10) + static_cast<uint64_t>(*str - '0'));
+      if (value > MAX_CHANNEL)
+        return false;
+    }
+    n[numCount++] = static_cast<uint32_t>(value);
+
+    // part suffix, the channel is what matters here
+    if (*str == '.')
+    {
+      for (str++; *str >= '0' && *str <= '9'; str++)
+        ;
+    }
+
+    if (*str == '-' && numCount == 1)
+      str++;
+    else
+      break;
+  }
+
+  while (*str == ' ')
+    str++;
+
+  if (*str != 0)
+    return false;
+
+  first = n[0];
+  last = ((numCount == 2) ? n[1] : n[0]);
+  if (first > last)
+  {
+    uint32_t temp = first;
+    first = last;
+    last = temp;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChannelBitmap::IsEmpty() const
+{
+  for (WORDS::const_iterator i = m_Words.begin(); i != m_Words.end(); i++)
+  {
+    if (*i != 0)
+      return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelBitmap::AddRange(uint32_t first, uint32_t last)
+{
+  // one bit per channel, so bound the words by the console's channel range
+  if (last > EosChannelSet::MAX_CHANNEL)
+    last = EosChannelSet::MAX_CHANNEL;
+  if (first > last)
+    return;
+
+  size_t firstWord = (first >> 6);
+  size_t lastWord = (last >> 6);
+  if (lastWord >= m_Words.size())
+    m_Words.resize(lastWord + 1, 0);
+
+  uint64_t firstMask = (~static_cast<uint64_t>(0) << (first & 63));
+  uint64_t lastMask = (~static_cast<uint64_t>(0) >> (63 - (last & 63)));
+  if (firstWord == lastWord)
+  {
+    m_Words[firstWord] |= (firstMask & lastMask);
+    return;
+  }
+
+  m_Words[firstWord] |= firstMask;
+  for (size_t i = (firstWord + 1); i < lastWord; i++)
+    m_Words[i] = ~static_cast<uint64_t>(0);
+  m_Words[lastWord] |= lastMask;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelBitmap::Add(const EosChannelSet &channels)
+{
+  const EosChannelSet::RUNS &runs = channels.GetRuns();
+  if (!runs.empty())
+  {
+    uint32_t last = ((runs.back().last > EosChannelSet::MAX_CHANNEL) ? static_cast<uint32_t>(EosChannelSet::MAX_CHANNEL) : runs.back().last);
+    if ((last >> 6) >= m_Words.size())
+      m_Words.resize((last >> 6) + 1, 0);
+  }
+
+  for (EosChannelSet::RUNS::const_iterator i = runs.begin(); i != runs.end(); i++)
+    AddRange(i->first, i->last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChannelBitmap::Contains(uint32_t channel) const
+{
+  size_t word = (channel >> 6);
+  return (word < m_Words.size() && (m_Words[word] & (static_cast<uint64_t>(1) << (channel & 63))) != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosChannelBitmap::GetNumChannels() const
+{
+  size_t count = 0;
+  for (size_t i = 0; i < m_Words.size(); i++)
+    count += PopCount(m_Words[i]);
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelBitmap::GetChannelSet(EosChannelSet &channels) const
+{
+  channels.Clear();
+
+  for (size_t i = 0; i < m_Words.size(); i++)
+  {
+    uint64_t word = m_Words[i];
+    while (word != 0)
+    {
+      // next run of set bits within this word
+      unsigned int start = CountTrailingZeros(word);
+      uint64_t rest = ~(word >> start);
+      unsigned int length = ((rest == 0) ? (64 - start) : CountTrailingZeros(rest));
+      if (length > (64 - start))
+        length = (64 - start);
+
+      uint32_t first = static_cast<uint32_t>((i << 6) + start);
+      channels.AddRange(first, first + (length - 1));
+
+      word = ((start + length >= 64) ? 0 : (word & (~static_cast<uint64_t>(0) << (start + length))));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelBitmap::And(const EosChannelBitmap &other)
+{
+  if (m_Words.size() > other.m_Words.size())
+    m_Words.resize(other.m_Words.size());
+
+  uint64_t *words = (m_Words.empty() ? 0 : (&m_Words[0]));
+  const uint64_t *otherWords = (other.m_Words.empty() ? 0 : (&other.m_Words[0]));
+  for (size_t i = 0; i < m_Words.size(); i++)
+    words[i] &= otherWords[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelBitmap::Or(const EosChannelBitmap &other)
+{
+  if (m_Words.size() < other.m_Words.size())
+    m_Words.resize(other.m_Words.size(), 0);
+
+  uint64_t *words = (m_Words.empty() ? 0 : (&m_Words[0]));
+  const uint64_t *otherWords = (other.m_Words.empty() ? 0 : (&other.m_Words[0]));
+  for (size_t i = 0; i < other.m_Words.size(); i++)
+    words[i] |= otherWords[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelBitmap::AndNot(const EosChannelBitmap &other)
+{
+  size_t count = ((m_Words.size() < other.m_Words.size()) ? m_Words.size() : other.m_Words.size());
+
+  uint64_t *words = (m_Words.empty() ? 0 : (&m_Words[0]));
+  const uint64_t *otherWords = (other.m_Words.empty() ? 0 : (&other.m_Words[0]));
+  for (size_t i = 0; i < count; i++)
+    words[i] &= ~otherWords[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosChannelBitmap::GetNumChannelsInBoth(const EosChannelBitmap &a, const EosChannelBitmap &b)
+{
+  size_t count = ((a.m_Words.size() < b.m_Words.size()) ? a.m_Words.size() : b.m_Words.size());
+
+  size_t n = 0;
+  for (size_t i = 0; i < count; i++)
+    n += PopCount(a.m_Words[i] & b.m_Words[i]);
+  return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int EosChannelBitmap::PopCount(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned int>(__builtin_popcountll(word));
+#elif defined(EOS_CHANNEL_SET_MSVC_64)
+  return static_cast<unsigned int>(__popcnt64(word));
+#else
+  word = (word - ((word >> 1) & 0x5555555555555555ull));
+  word = ((word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull));
+  word = ((word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full);
+  return static_cast<unsigned int>((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int EosChannelBitmap::CountTrailingZeros(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned int>(__builtin_ctzll(word));
+#elif defined(EOS_CHANNEL_SET_MSVC_64)
+  unsigned long index = 0;
+  _BitScanForward64(&index, word);
+  return static_cast<unsigned int>(index);
+#else
+  unsigned int n = 0;
+  while ((word & 1) == 0)
+  {
+    word >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,120 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_CHANNEL_SET_H
+#define EOS_CHANNEL_SET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Set of channel numbers stored as sorted, non-adjacent inclusive runs.
+// Channel lists are mostly a few long ranges, so "1-30000" costs a single run.
+class EosChannelSet
+{
+public:
+  enum EnumConstants
+  {
+    MAX_CHANNEL = 99999  // highest channel number Eos supports
+  };
+
+  struct sRun
+  {
+    uint32_t first;
+    uint32_t last;  // inclusive
+  };
+
+  typedef std::vector<sRun> RUNS;
+
+  EosChannelSet()
+    : m_NumChannels(0)
+  {
+  }
+
+  bool operator==(const EosChannelSet &other) const;
+  bool operator!=(const EosChannelSet &other) const { return !(*this == other); }
+
+  void Clear();
+  bool IsEmpty() const { return m_Runs.empty(); }
+  size_t GetNumChannels() const { return m_NumChannels; }
+  const RUNS &GetRuns() const { return m_Runs; }
+  void Add(uint32_t channel) { AddRange(channel, channel); }
+  void AddRange(uint32_t first, uint32_t last);
+  bool Contains(uint32_t channel) const;
+  bool Intersects(const EosChannelSet &other) const;
+  void GetChannels(std::vector<uint32_t> &channels) const;
+
+  // result may be either input
+  static void Union(const EosChannelSet &a, const EosChannelSet &b, EosChannelSet &result);
+  static void Intersect(const EosChannelSet &a, const EosChannelSet &b, EosChannelSet &result);
+  static void Subtract(const EosChannelSet &a, const EosChannelSet &b, EosChannelSet &result);  // a and not b
+
+  // "12", "1-10" or "3.2" (channel 3), leading and trailing spaces ignored, fails above MAX_CHANNEL
+  static bool ParseRange(const char *str, uint32_t &first, uint32_t &last);
+
+private:
+  RUNS m_Runs;
+  size_t m_NumChannels;
+
+  void Append(uint32_t first, uint32_t last);  // first must not be below the last run's first
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Dense form of a channel set, one bit per channel up to the highest channel set.
+// Channels above EosChannelSet::MAX_CHANNEL are ignored.
+// Meant for combining many sets at once, e.g. "channels of group 5 not in any color palette":
+// every operation is a single pass over 64-bit words with hardware popcount where available.
+class EosChannelBitmap
+{
+public:
+  typedef std::vector<uint64_t> WORDS;
+
+  EosChannelBitmap() {}
+  explicit EosChannelBitmap(const EosChannelSet &channels) { Add(channels); }
+
+  void Clear() { m_Words.clear(); }
+  bool IsEmpty() const;
+  const WORDS &GetWords() const { return m_Words; }
+  void Add(uint32_t channel) { AddRange(channel, channel); }
+  void AddRange(uint32_t first, uint32_t last);
+  void Add(const EosChannelSet &channels);
+  bool Contains(uint32_t channel) const;
+  size_t GetNumChannels() const;
+  void GetChannelSet(EosChannelSet &channels) const;
+
+  void And(const EosChannelBitmap &other);
+  void Or(const EosChannelBitmap &other);
+  void AndNot(const EosChannelBitmap &other);
+
+  static size_t GetNumChannelsInBoth(const EosChannelBitmap &a, const EosChannelBitmap &b);
+  static unsigned int PopCount(uint64_t word);
+  static unsigned int CountTrailingZeros(uint64_t word);  // word must not be 0
+
+private:
+  WORDS m_Words;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
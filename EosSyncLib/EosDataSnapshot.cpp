@@ -0,0 +1,371 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosDataSnapshot.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosDataSnapshot::sTarget *EosDataSnapshot::sList::Find(const EosTarget::sTargetKey &key) const
+{
+  size_t first = 0;
+  size_t count = targets.size();
+  while (count != 0)
+  {
+    size_t step = (count / 2);
+    if (targets[first + step]->key < key)
+    {
+      first += (step + 1);
+      count -= (step + 1);
+    }
+    else
+      count = step;
+  }
+
+  if (first < targets.size() && targets[first]->key == key)
+    return targets[first].get();
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshot::EosDataSnapshot(uint64_t version, EosSyncStatus::EnumSyncStatus status)
+  : m_Version(version)
+  , m_Status(status)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosDataSnapshot::sList *EosDataSnapshot::GetList(EosTarget::EnumEosTargetType type, int listId) const
+{
+  SHOW_DATA::const_iterator showDataIter = m_ShowData.find(type);
+  if (showDataIter != m_ShowData.end())
+  {
+    TARGETLIST_DATA::const_iterator listIter = showDataIter->second.find(listId);
+    if (listIter != showDataIter->second.end())
+      return listIter->second.get();
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosDataSnapshot::IsSameAs(const EosDataSnapshot &other) const
+{
+  if (m_Status != other.m_Status || m_ShowData.size() != other.m_ShowData.size())
+    return false;
+
+  // unchanged lists are shared, so comparing pointers is enough
+  for (SHOW_DATA::const_iterator i = m_ShowData.begin(), j = other.m_ShowData.begin(); i != m_ShowData.end(); i++, j++)
+  {
+    if (i->first != j->first || i->second.size() != j->second.size())
+      return false;
+
+    for (TARGETLIST_DATA::const_iterator k = i->second.begin(), l = j->second.begin(); k != i->second.end(); k++, l++)
+    {
+      if (k->first != l->first || k->second != l->second)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshot *EosDataSnapshot::Create(const EosSyncData &data, const EosDataSnapshot *prev, uint64_t version)
+{
+  EosDataSnapshot *snapshot = new EosDataSnapshot(version, data.GetStatus().GetValue());
+
+  const EosSyncData::SHOW_DATA &showData = data.GetShowData();
+  for (EosSyncData::SHOW_DATA::const_iterator i = showData.begin(); i != showData.end(); i++)
+  {
+    const TARGETLIST_DATA *prevLists = 0;
+    if (prev)
+    {
+      SHOW_DATA::const_iterator prevIter = prev->m_ShowData.find(i->first);
+      if (prevIter != prev->m_ShowData.end())
+        prevLists = &(prevIter->second);
+    }
+
+    TARGETLIST_DATA &lists = snapshot->m_ShowData[i->first];
+    for (EosSyncData::TARGETLIST_DATA::const_iterator j = i->second.begin(); j != i->second.end(); j++)
+    {
+      if (!j->second)
+        continue;
+
+      LIST_PTR prevList;
+      if (prevLists)
+      {
+        TARGETLIST_DATA::const_iterator prevIter = prevLists->find(j->first);
+        if (prevIter != prevLists->end())
+          prevList = prevIter->second;
+      }
+
+      lists[j->first] = CreateList(*(j->second), prevList);
+    }
+  }
+
+  return snapshot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshot::LIST_PTR EosDataSnapshot::CreateList(const EosTargetList &targetList, const LIST_PTR &prev)
+{
+  EosSyncStatus::EnumSyncStatus status = targetList.GetStatus().GetValue();
+
+  if (prev && prev->generation == targetList.GetGeneration() && prev->revision == targetList.GetRevision() && prev->status == status)
+    return prev;  // unchanged, share it
+
+  std::shared_ptr<sList> list = std::make_shared<sList>();
+  list->type = targetList.GetType();
+  list->listId = targetList.GetListId();
+  list->status = status;
+  list->generation = targetList.GetGeneration();
+  list->revision = targetList.GetRevision();
+  list->targets.reserve(targetList.GetNumTargets());
+
+  // both are sorted by key, so unchanged targets are picked up in a single merge pass
+  size_t prevIndex = 0;
+  size_t prevCount = (prev ? prev->targets.size() : 0);
+
+  const EosTargetList::TARGETS &targets = targetList.GetTargets();
+  for (EosTargetList::TARGETS::const_iterator i = targets.begin(); i != targets.end(); i++)
+  {
+    const EosTargetList::PARTS &parts = i->second.list;
+    for (EosTargetList::PARTS::const_iterator j = parts.begin(); j != parts.end(); j++)
+    {
+      const EosTarget *target = j->second;
+      if (!target)
+        continue;
+
+      EosTarget::sTargetKey key(i->first, j->first);
+      while (prevIndex < prevCount && prev->targets[prevIndex]->key < key)
+        prevIndex++;
+
+      if (prevIndex < prevCount)
+      {
+        const TARGET_PTR &prevTarget = prev->targets[prevIndex];
+        if (prevTarget->key == key && prevTarget->generation == target->GetGeneration() && prevTarget->revision == target->GetRevision() &&
+            prevTarget->status == target->GetStatus().GetValue())
+        {
+          list->targets.push_back(prevTarget);
+          continue;
+        }
+      }
+
+      list->targets.push_back(CreateTarget(key, *target));
+    }
+  }
+
+  return list;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshot::TARGET_PTR EosDataSnapshot::CreateTarget(const EosTarget::sTargetKey &key, const EosTarget &target)
+{
+  std::shared_ptr<sTarget> t = std::make_shared<sTarget>();
+  t->key = key;
+  t->uid = target.GetUID();
+  t->status = target.GetStatus().GetValue();
+  t->numPropGroups = target.GetNumPropGroups();
+  t->generation = target.GetGeneration();
+  t->revision = target.GetRevision();
+
+  for (unsigned int slot = 0; slot < t->numPropGroups && slot < EosTarget::MAX_PROP_GROUPS; slot++)
+  {
+    size_t numProps = target.GetNumProps(slot);
+    std::vector<std::string> &props = t->props[slot];
+    props.resize(numProps);
+    for (size_t i = 0; i < numProps; i++)
+    {
+      const char *str = target.GetPropString(slot, static_cast<unsigned int>(i));
+      if (str)
+        props[i] = str;
+      else
+        target.GetPropString(slot, static_cast<unsigned int>(i), props[i]);  // int or float argument in column storage
+    }
+  }
+
+  return t;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshotManager::EosDataSnapshotManager()
+  : m_Current(0)
+  , m_Epoch(1)
+{
+  for (unsigned int i = 0; i < MAX_READERS; i++)
+  {
+    m_Readers[i].used.store(false);
+    m_Readers[i].epoch.store(0);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshotManager::~EosDataSnapshotManager()
+{
+  // readers must be gone by now
+  delete m_Current.exchange(0);
+
+  for (RETIRED::const_iterator i = m_Retired.begin(); i != m_Retired.end(); i++)
+    delete i->snapshot;
+  m_Retired.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosDataSnapshotManager::Publish(EosDataSnapshot *snapshot)
+{
+  EosDataSnapshot *old = m_Current.exchange(snapshot);
+  if (old)
+  {
+    // any reader that entered at or before this epoch may still hold it
+    sRetired retired;
+    retired.snapshot = old;
+    retired.epoch = m_Epoch.load();
+    m_Retired.push_back(retired);
+  }
+
+  m_Epoch++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosDataSnapshotManager::Reclaim()
+{
+  if (m_Retired.empty())
+    return 0;
+
+  uint64_t minEpoch = 0;
+  for (unsigned int i = 0; i < MAX_READERS; i++)
+  {
+    uint64_t epoch = m_Readers[i].epoch.load();
+    if (epoch != 0 && (minEpoch == 0 || epoch < minEpoch))
+      minEpoch = epoch;
+  }
+
+  size_t count = 0;
+  for (RETIRED::iterator i = m_Retired.begin(); i != m_Retired.end();)
+  {
+    if (minEpoch == 0 || i->epoch < minEpoch)
+    {
+      delete i->snapshot;
+      i = m_Retired.erase(i);
+      count++;
+    }
+    else
+      i++;
+  }
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int EosDataSnapshotManager::RegisterReader()
+{
+  for (int i = 0; i < MAX_READERS; i++)
+  {
+    bool used = false;
+    if (m_Readers[i].used.compare_exchange_strong(used, true))
+      return i;
+  }
+
+  return INVALID_READER;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosDataSnapshotManager::UnregisterReader(int reader)
+{
+  if (reader >= 0 && reader < MAX_READERS)
+  {
+    m_Readers[reader].epoch.store(0);
+    m_Readers[reader].used.store(false);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosDataSnapshot *EosDataSnapshotManager::Enter(int reader)
+{
+  if (reader < 0 || reader >= MAX_READERS)
+    return 0;
+
+  // announce the epoch before loading, so a snapshot retired after this point is kept
+  m_Readers[reader].epoch.store(m_Epoch.load());
+  return m_Current.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosDataSnapshotManager::Leave(int reader)
+{
+  if (reader >= 0 && reader < MAX_READERS)
+    m_Readers[reader].epoch.store(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshotReader::EosDataSnapshotReader(EosDataSnapshotManager &manager)
+  : m_Manager(manager)
+  , m_Reader(manager.RegisterReader())
+  , m_Locked(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosDataSnapshotReader::~EosDataSnapshotReader()
+{
+  Unlock();
+  m_Manager.UnregisterReader(m_Reader);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosDataSnapshot *EosDataSnapshotReader::Lock()
+{
+  if (m_Reader == EosDataSnapshotManager::INVALID_READER)
+    return 0;
+
+  m_Locked = true;
+  return m_Manager.Enter(m_Reader);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosDataSnapshotReader::Unlock()
+{
+  if (m_Locked)
+  {
+    m_Manager.Leave(m_Reader);
+    m_Locked = false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
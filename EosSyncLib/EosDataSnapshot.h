@@ -0,0 +1,175 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_DATA_SNAPSHOT_H
+#define EOS_DATA_SNAPSHOT_H
+
+#ifndef EOS_SYNC_LIB_H
+#include "EosSyncLib.h"
+#endif
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Immutable copy of the synchronized show data. Lists and targets are shared between
+// consecutive snapshots when they did not change, so publishing only copies what moved.
+class EosDataSnapshot
+{
+public:
+  struct sTarget
+  {
+    EosTarget::sTargetKey key;
+    EosTarget::sUID uid;
+    EosSyncStatus::EnumSyncStatus status;
+    unsigned int numPropGroups;
+    std::vector<std::string> props[EosTarget::MAX_PROP_GROUPS];  // by group slot
+    uint64_t generation;                                          // source target
+    unsigned int revision;                                        // source target
+  };
+
+  typedef std::shared_ptr<const sTarget> TARGET_PTR;
+  typedef std::vector<TARGET_PTR> TARGETS;  // sorted by key
+
+  struct sList
+  {
+    EosTarget::EnumEosTargetType type;
+    int listId;
+    EosSyncStatus::EnumSyncStatus status;
+    TARGETS targets;
+    uint64_t generation;    // source list
+    unsigned int revision;  // source list
+
+    const sTarget *Find(const EosTarget::sTargetKey &key) const;
+  };
+
+  typedef std::shared_ptr<const sList> LIST_PTR;
+  typedef std::map<int, LIST_PTR> TARGETLIST_DATA;
+  typedef std::map<EosTarget::EnumEosTargetType, TARGETLIST_DATA> SHOW_DATA;
+
+  EosDataSnapshot(uint64_t version, EosSyncStatus::EnumSyncStatus status);
+  virtual ~EosDataSnapshot() {}
+
+  virtual uint64_t GetVersion() const { return m_Version; }
+  virtual EosSyncStatus::EnumSyncStatus GetStatus() const { return m_Status; }
+  virtual const SHOW_DATA &GetShowData() const { return m_ShowData; }
+  virtual const sList *GetList(EosTarget::EnumEosTargetType type, int listId) const;
+  virtual bool IsSameAs(const EosDataSnapshot &other) const;
+
+  static EosDataSnapshot *Create(const EosSyncData &data, const EosDataSnapshot *prev, uint64_t version);
+  static LIST_PTR CreateList(const EosTargetList &targetList, const LIST_PTR &prev);
+  static TARGET_PTR CreateTarget(const EosTarget::sTargetKey &key, const EosTarget &target);
+
+private:
+  uint64_t m_Version;
+  EosSyncStatus::EnumSyncStatus m_Status;
+  SHOW_DATA m_ShowData;
+
+  // not allowed
+  EosDataSnapshot(const EosDataSnapshot &);
+  EosDataSnapshot &operator=(const EosDataSnapshot &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Publishes snapshots from the sync thread to any number of reader threads.
+// Readers enter an epoch, load the current snapshot with a single atomic load and leave
+// when done; they never wait on the sync thread. Replaced snapshots are retired with the
+// epoch they were replaced in and deleted by Reclaim() once no reader can still see them.
+class EosDataSnapshotManager
+{
+public:
+  enum EnumConstants
+  {
+    MAX_READERS = 64,
+    INVALID_READER = -1
+  };
+
+  EosDataSnapshotManager();
+  virtual ~EosDataSnapshotManager();
+
+  // sync thread
+  virtual void Publish(EosDataSnapshot *snapshot);
+  virtual const EosDataSnapshot *GetLatest() const { return m_Current.load(std::memory_order_relaxed); }
+  virtual size_t Reclaim();
+  virtual size_t GetNumRetired() const { return m_Retired.size(); }
+
+  // reader threads
+  virtual int RegisterReader();
+  virtual void UnregisterReader(int reader);
+  virtual const EosDataSnapshot *Enter(int reader);
+  virtual void Leave(int reader);
+
+private:
+  struct sReaderSlot
+  {
+    std::atomic<bool> used;
+    std::atomic<uint64_t> epoch;  // 0 when not reading
+    char padding[48];             // one slot per cache line
+  };
+
+  struct sRetired
+  {
+    EosDataSnapshot *snapshot;
+    uint64_t epoch;
+  };
+
+  typedef std::vector<sRetired> RETIRED;
+
+  std::atomic<EosDataSnapshot *> m_Current;
+  std::atomic<uint64_t> m_Epoch;
+  sReaderSlot m_Readers[MAX_READERS];
+  RETIRED m_Retired;
+
+  // not allowed
+  EosDataSnapshotManager(const EosDataSnapshotManager &);
+  EosDataSnapshotManager &operator=(const EosDataSnapshotManager &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Reader side helper, one per reader thread
+class EosDataSnapshotReader
+{
+public:
+  EosDataSnapshotReader(EosDataSnapshotManager &manager);
+  virtual ~EosDataSnapshotReader();
+
+  virtual bool IsValid() const { return (m_Reader != EosDataSnapshotManager::INVALID_READER); }
+  virtual const EosDataSnapshot *Lock();  // valid until Unlock
+  virtual void Unlock();
+
+private:
+  EosDataSnapshotManager &m_Manager;
+  int m_Reader;
+  bool m_Locked;
+
+  // not allowed
+  EosDataSnapshotReader(const EosDataSnapshotReader &);
+  EosDataSnapshotReader &operator=(const EosDataSnapshotReader &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,286 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_FLAT_MAP_H
+#define EOS_FLAT_MAP_H
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Ordered map stored as a sorted contiguous array, with room for N elements
+// inline before anything is allocated. Keeps the std::map interface used by the
+// sync data (find, operator[], erase, ordered iteration with first/second).
+// Inserting or erasing moves the elements after it and invalidates iterators.
+template <class K, class V, size_t N = 0>
+class EosFlatMap
+{
+public:
+  typedef K key_type;
+  typedef V mapped_type;
+  typedef std::pair<K, V> value_type;
+  typedef size_t size_type;
+  typedef value_type *iterator;
+  typedef const value_type *const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  EosFlatMap()
+    : m_Data(GetInline())
+    , m_Size(0)
+    , m_Capacity(N)
+  {
+  }
+
+  EosFlatMap(const EosFlatMap &other)
+    : m_Data(GetInline())
+    , m_Size(0)
+    , m_Capacity(N)
+  {
+    reserve(other.m_Size);
+    for (; m_Size < other.m_Size; m_Size++)
+      new (&m_Data[m_Size]) value_type(other.m_Data[m_Size]);
+  }
+
+  EosFlatMap(EosFlatMap &&other)
+    : m_Data(GetInline())
+    , m_Size(0)
+    , m_Capacity(N)
+  {
+    Take(other);
+  }
+
+  ~EosFlatMap()
+  {
+    clear();
+    Free();
+  }
+
+  EosFlatMap &operator=(const EosFlatMap &other)
+  {
+    if (this != &other)
+    {
+      clear();
+      reserve(other.m_Size);
+      for (; m_Size < other.m_Size; m_Size++)
+        new (&m_Data[m_Size]) value_type(other.m_Data[m_Size]);
+    }
+    return *this;
+  }
+
+  EosFlatMap &operator=(EosFlatMap &&other)
+  {
+    if (this != &other)
+    {
+      clear();
+      Free();
+      Take(other);
+    }
+    return *this;
+  }
+
+  iterator begin() { return m_Data; }
+  const_iterator begin() const { return m_Data; }
+  iterator end() { return (m_Data + m_Size); }
+  const_iterator end() const { return (m_Data + m_Size); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  bool empty() const { return (m_Size == 0); }
+  size_type size() const { return m_Size; }
+  size_type capacity() const { return m_Capacity; }
+
+  iterator lower_bound(const K &key) { return (m_Data + LowerBound(key)); }
+  const_iterator lower_bound(const K &key) const { return (m_Data + LowerBound(key)); }
+  iterator upper_bound(const K &key) { return (m_Data + UpperBound(key)); }
+  const_iterator upper_bound(const K &key) const { return (m_Data + UpperBound(key)); }
+
+  iterator find(const K &key)
+  {
+    size_t i = LowerBound(key);
+    return ((i < m_Size && !(key < m_Data[i].first)) ? (m_Data + i) : end());
+  }
+
+  const_iterator find(const K &key) const
+  {
+    size_t i = LowerBound(key);
+    return ((i < m_Size && !(key < m_Data[i].first)) ? (m_Data + i) : end());
+  }
+
+  size_type count(const K &key) const { return ((find(key) == end()) ? 0 : 1); }
+
+  V &operator[](const K &key)
+  {
+    size_t i = LowerBound(key);
+    if (i == m_Size || key < m_Data[i].first)
+      InsertAt(i, value_type(key, V()));
+    return m_Data[i].second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value)
+  {
+    size_t i = LowerBound(value.first);
+    if (i < m_Size && !(value.first < m_Data[i].first))
+      return std::pair<iterator, bool>(m_Data + i, false);
+    InsertAt(i, value);
+    return std::pair<iterator, bool>(m_Data + i, true);
+  }
+
+  iterator erase(iterator pos)
+  {
+    size_t i = static_cast<size_t>(pos - m_Data);
+    for (size_t j = i + 1; j < m_Size; j++)
+      m_Data[j - 1] = std::move(m_Data[j]);
+    m_Data[--m_Size].~value_type();
+    return (m_Data + i);
+  }
+
+  size_type erase(const K &key)
+  {
+    iterator i = find(key);
+    if (i == end())
+      return 0;
+    erase(i);
+    return 1;
+  }
+
+  void clear()
+  {
+    while (m_Size != 0)
+      m_Data[--m_Size].~value_type();
+  }
+
+  void reserve(size_type capacity)
+  {
+    if (capacity <= m_Capacity)
+      return;
+
+    size_t newCapacity = ((m_Capacity < 4) ? 4 : (m_Capacity * 2));
+    if (newCapacity < capacity)
+      newCapacity = capacity;
+
+    value_type *data = static_cast<value_type *>(::operator new(newCapacity * sizeof(value_type)));
+    for (size_t i = 0; i < m_Size; i++)
+    {
+      new (&data[i]) value_type(std::move(m_Data[i]));
+      m_Data[i].~value_type();
+    }
+
+    Free();
+    m_Data = data;
+    m_Capacity = newCapacity;
+  }
+
+private:
+  typedef typename std::aligned_storage<sizeof(value_type) * (N ? N : 1), std::alignment_of<value_type>::value>::type INLINE_STORAGE;
+
+  value_type *m_Data;
+  size_t m_Size;
+  size_t m_Capacity;
+  INLINE_STORAGE m_Inline;
+
+  value_type *GetInline() { return reinterpret_cast<value_type *>(&m_Inline); }
+  bool IsInline() const { return (m_Data == reinterpret_cast<const value_type *>(&m_Inline)); }
+
+  size_t LowerBound(const K &key) const
+  {
+    // appending in order is the common case during sync
+    if (m_Size == 0 || m_Data[m_Size - 1].first < key)
+      return m_Size;
+
+    size_t first = 0;
+    size_t count = m_Size;
+    while (count != 0)
+    {
+      size_t step = (count / 2);
+      if (m_Data[first + step].first < key)
+      {
+        first += (step + 1);
+        count -= (step + 1);
+      }
+      else
+        count = step;
+    }
+    return first;
+  }
+
+  size_t UpperBound(const K &key) const
+  {
+    size_t i = LowerBound(key);
+    return ((i < m_Size && !(key < m_Data[i].first)) ? (i + 1) : i);
+  }
+
+  void InsertAt(size_t i, const value_type &value)
+  {
+    value_type v(value);  // value may live in this map
+    reserve(m_Size + 1);
+    if (i == m_Size)
+    {
+      new (&m_Data[m_Size]) value_type(std::move(v));
+    }
+    else
+    {
+      new (&m_Data[m_Size]) value_type(std::move(m_Data[m_Size - 1]));
+      for (size_t j = m_Size - 1; j > i; j--)
+        m_Data[j] = std::move(m_Data[j - 1]);
+      m_Data[i] = std::move(v);
+    }
+    m_Size++;
+  }
+
+  void Free()
+  {
+    if (!IsInline())
+      ::operator delete(m_Data);
+    m_Data = GetInline();
+    m_Capacity = N;
+  }
+
+  void Take(EosFlatMap &other)
+  {
+    if (other.IsInline())
+    {
+      for (; m_Size < other.m_Size; m_Size++)
+        new (&m_Data[m_Size]) value_type(std::move(other.m_Data[m_Size]));
+      other.clear();
+    }
+    else
+    {
+      m_Data = other.m_Data;
+      m_Size = other.m_Size;
+      m_Capacity = other.m_Capacity;
+      other.m_Data = other.GetInline();
+      other.m_Size = 0;
+      other.m_Capacity = N;
+    }
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
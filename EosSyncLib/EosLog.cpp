@@ -19,33 +19,168 @@
 // THE SOFTWARE.
 
 #include "EosLog.h"
+#include "EosLogRing.h"
 #include <time.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosLog::Add(EnumLogMsgType type, const std::string &text)
+void EosLog::SetMinLevel(EnumLogMsgType type)
 {
+	EnumLogMsgType minLevel = GetLevel(type);
+	for(unsigned int i=0; i<=LOG_MSG_TYPE_SEND; i++)
+	{
+		EnumLogMsgType t = static_cast<EnumLogMsgType>(i);
+		SetTypeEnabled(t, GetLevel(t)>=minLevel);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLog::SetTypeEnabled(EnumLogMsgType type, bool enabled)
+{
+	if( enabled )
+		m_Filter |= (1u << type);
+	else
+		m_Filter &= ~(1u << type);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosLog::EnumLogMsgType EosLog::GetLevel(EnumLogMsgType type)
+{
+	switch( type )
+	{
+		case LOG_MSG_TYPE_RECV:
+		case LOG_MSG_TYPE_SEND:
+			return LOG_MSG_TYPE_DEBUG;	// packet tracing is debug verbosity
+
+		default:
+			break;
+	}
+
+	return type;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLog::Clear()
+{
+	// the ring has a single consumer, leave it to the consumer thread when running
+	if( m_Ring && !m_Ring->IsConsumerRunning() )
+	{
+		EosLogRing::sRecord record;
+		while( m_Ring->Pop(record) )
+			;
+	}
+
+	m_Q.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLog::Add(EnumLogMsgType type, const char *text, size_t size)
+{
+	if( !IsEnabled(type) )
+		return;
+
+	if( m_Ring )
+	{
+		// no allocation, safe from any thread
+		m_Ring->Push(EosLogRing::MSG_ID_TEXT, type, text, size);
+		return;
+	}
+
 	sLogMsg msg;
 	msg.type = type;
 	msg.timestamp = time(0);
-	msg.text = text;
+	if( text )
+		msg.text.assign(text, size);
 	m_Q.push_back(msg);
 
 	//switch( type )
 	//{
 	//	case LOG_MSG_TYPE_WARNING:
 	//	case LOG_MSG_TYPE_ERROR:
-	//		printf("%s\n", text.c_str());	// convienient place to set a breakpoint
+	//		printf("%s\n", msg.text.c_str());	// convienient place to set a breakpoint
 	//		break;
 	//}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void EosLog::AddRecord(EnumLogMsgType type, unsigned int id, const void *payload, size_t size)
+{
+	if( !IsEnabled(type) )
+		return;
+
+	if( m_Ring )
+	{
+		m_Ring->Push(id, type, payload, size);
+		return;
+	}
+
+	// no ring, format now
+	EosLogRing::sRecord record;
+	record.id = id;
+	record.type = static_cast<uint8_t>(type);
+	record.flags = 0;
+	if( size > EosLogRing::MAX_PAYLOAD_SIZE )
+	{
+		size = EosLogRing::MAX_PAYLOAD_SIZE;
+		record.flags |= EosLogRing::RECORD_FLAG_TRUNCATED;
+	}
+	record.size = static_cast<uint16_t>(size);
+	if( payload && size!=0 )
+		memcpy(record.payload, payload, size);
+
+	sLogMsg msg;
+	msg.type = type;
+	msg.timestamp = time(0);
+	EosLogRing::Format(record, msg.text);
+	m_Q.push_back(msg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLog::AddQ(const LOG_Q &q)
+{
+	if( m_Ring )
+	{
+		for(LOG_Q::const_iterator i=q.begin(); i!=q.end(); i++)
+			Add(i->type, i->text);
+	}
+	else
+		m_Q.insert(m_Q.end(), q.begin(), q.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void EosLog::Flush(LOG_Q &q)
 {
 	q.clear();
 	m_Q.swap(q);
+
+	// the ring has a single consumer, leave it to the consumer thread when running
+	if( m_Ring && !m_Ring->IsConsumerRunning() )
+	{
+		// drain the ring, formatting happens here on the consumer side
+		EosLogRing::sRecord record;
+		while( m_Ring->Pop(record) )
+		{
+			sLogMsg msg;
+			msg.type = static_cast<EnumLogMsgType>(record.type);
+			msg.timestamp = m_Ring->GetWallClockTime(record.timestamp);
+			EosLogRing::Format(record, msg.text);
+			q.push_back(msg);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosLog::Size() const
+{
+	return (m_Q.size() + (m_Ring ? m_Ring->GetSize() : 0));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
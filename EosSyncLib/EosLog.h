@@ -24,6 +24,10 @@
 
 #include <vector>
 #include <string>
+#include <time.h>
+#include <string.h>
+
+class EosLogRing;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -49,21 +53,46 @@ public:
 
   typedef std::vector<sLogMsg> LOG_Q;
 
-  EosLog() {}
+  EosLog()
+    : m_Filter(LOG_FILTER_ALL)
+    , m_Ring(0)
+  {
+  }
 
-  void Clear() { m_Q.clear(); }
-  void Add(EnumLogMsgType type, const std::string &text);
+  void Clear();
+  void SetMinLevel(EnumLogMsgType type);
+  void SetTypeEnabled(EnumLogMsgType type, bool enabled);
+  bool IsEnabled(EnumLogMsgType type) const { return ((m_Filter & (1u << type)) != 0); }
+  void SetRing(EosLogRing *ring) { m_Ring = ring; }  // not owned, messages go to the ring instead of the queue when set, Flush drains it unless its consumer thread is running
+  EosLogRing *GetRing() const { return m_Ring; }
+  void Add(EnumLogMsgType type, const std::string &text) { Add(type, text.c_str(), text.size()); }
+  void Add(EnumLogMsgType type, const char *text) { Add(type, text, text ? strlen(text) : 0); }
+  void Add(EnumLogMsgType type, const char *text, size_t size);
+  void AddRecord(EnumLogMsgType type, unsigned int id, const void *payload, size_t size);
   void AddDebug(const std::string &text) { Add(LOG_MSG_TYPE_DEBUG, text); }
+  void AddDebug(const char *text) { Add(LOG_MSG_TYPE_DEBUG, text); }
   void AddInfo(const std::string &text) { Add(LOG_MSG_TYPE_INFO, text); }
+  void AddInfo(const char *text) { Add(LOG_MSG_TYPE_INFO, text); }
   void AddWarning(const std::string &text) { Add(LOG_MSG_TYPE_WARNING, text); }
+  void AddWarning(const char *text) { Add(LOG_MSG_TYPE_WARNING, text); }
   void AddError(const std::string &text) { Add(LOG_MSG_TYPE_ERROR, text); }
+  void AddError(const char *text) { Add(LOG_MSG_TYPE_ERROR, text); }
   void AddLog(const EosLog &other) { AddQ(other.m_Q); }
-  void AddQ(const LOG_Q &q) { m_Q.insert(m_Q.end(), q.begin(), q.end()); }
+  void AddQ(const LOG_Q &q);
   void Flush(LOG_Q &q);
-  size_t Size() const { return m_Q.size(); }
+  size_t Size() const;
+
+  static EnumLogMsgType GetLevel(EnumLogMsgType type);
 
 private:
+  enum EnumConstants
+  {
+    LOG_FILTER_ALL = 0xffffffff
+  };
+
   LOG_Q m_Q;
+  unsigned int m_Filter;
+  EosLogRing *m_Ring;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
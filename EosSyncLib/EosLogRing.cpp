@@ -0,0 +1,232 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosLogRing.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <chrono>
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosLogRing::EosLogRing(size_t capacity)
+  : m_Cells(0)
+  , m_Mask(0)
+  , m_EnqueuePos(0)
+  , m_DequeuePos(0)
+  , m_Overflow(0)
+  , m_ConsumerRunning(false)
+  , m_ConsumerStop(false)
+{
+  size_t n = 2;
+  while (n < capacity)
+    n <<= 1;
+
+  m_Cells = new sCell[n];
+  m_Mask = (n - 1);
+  for (size_t i = 0; i < n; i++)
+    m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+
+  m_StartTimestamp = GetTimestamp();
+  m_StartTime = time(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosLogRing::~EosLogRing()
+{
+  StopConsumer();
+  delete[] m_Cells;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosLogRing::Push(uint32_t id, int type, const void *payload, size_t size)
+{
+  sCell *cell;
+  size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    cell = &m_Cells[pos & m_Mask];
+    size_t seq = cell->sequence.load(std::memory_order_acquire);
+    intptr_t dif = (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos));
+    if (dif == 0)
+    {
+      // slot is free, claim it
+      if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (dif < 0)
+    {
+      // full, consumer has not caught up yet
+      m_Overflow.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    else
+      pos = m_EnqueuePos.load(std::memory_order_relaxed);
+  }
+
+  sRecord &record = cell->record;
+  record.id = id;
+  record.type = static_cast<uint8_t>(type);
+  record.flags = 0;
+  record.reserved = 0;
+  record.timestamp = GetTimestamp();
+  if (size > MAX_PAYLOAD_SIZE)
+  {
+    size = MAX_PAYLOAD_SIZE;
+    record.flags |= RECORD_FLAG_TRUNCATED;
+  }
+  record.size = static_cast<uint16_t>(size);
+  if (payload && size != 0)
+    memcpy(record.payload, payload, size);
+
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosLogRing::Pop(sRecord &record)
+{
+  // single consumer only
+  size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+  sCell *cell = &m_Cells[pos & m_Mask];
+  size_t seq = cell->sequence.load(std::memory_order_acquire);
+  if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+    return false;  // empty
+
+  record = cell->record;
+  cell->sequence.store(pos + m_Mask + 1, std::memory_order_release);
+  m_DequeuePos.store(pos + 1, std::memory_order_relaxed);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosLogRing::Drain(EosLogSink &sink)
+{
+  size_t count = 0;
+  sRecord record;
+  while (Pop(record))
+  {
+    sink.EosLogSink_Recv(*this, record);
+    count++;
+  }
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosLogRing::GetSize() const
+{
+  size_t enqueuePos = m_EnqueuePos.load(std::memory_order_relaxed);
+  size_t dequeuePos = m_DequeuePos.load(std::memory_order_relaxed);
+  return ((enqueuePos > dequeuePos) ? (enqueuePos - dequeuePos) : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosLogRing::StartConsumer(EosLogSink &sink, unsigned int intervalMS)
+{
+  if (m_ConsumerThread.joinable())
+    return false;
+
+  m_ConsumerStop.store(false);
+  m_ConsumerRunning.store(true);
+  m_ConsumerThread = std::thread(&EosLogRing::ConsumerThreadRun, this, &sink, intervalMS);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLogRing::StopConsumer()
+{
+  if (m_ConsumerThread.joinable())
+  {
+    // still running until its last drain is done
+    m_ConsumerStop.store(true);
+    m_ConsumerThread.join();
+    m_ConsumerRunning.store(false);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLogRing::ConsumerThreadRun(EosLogSink *sink, unsigned int intervalMS)
+{
+  while (!m_ConsumerStop.load())
+  {
+    if (Drain(*sink) == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(intervalMS));
+  }
+
+  Drain(*sink);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+time_t EosLogRing::GetWallClockTime(uint64_t timestamp) const
+{
+  if (timestamp > m_StartTimestamp)
+    return (m_StartTime + static_cast<time_t>((timestamp - m_StartTimestamp) / 1000000));
+
+  return m_StartTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t EosLogRing::GetTimestamp()
+{
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLogRing::Format(const sRecord &record, std::string &text)
+{
+  switch (record.id)
+  {
+    case MSG_ID_TEXT:
+      text.assign(record.payload, record.size);
+      if (record.flags & RECORD_FLAG_TRUNCATED)
+        text.append("...");
+      return;
+
+    case MSG_ID_OSC_RECV:
+    case MSG_ID_OSC_SEND:
+      if (record.size >= sizeof(uint32_t))
+      {
+        uint32_t packetSize;
+        memcpy(&packetSize, record.payload, sizeof(packetSize));
+        char buf[64];
+        sprintf(buf, (record.id == MSG_ID_OSC_RECV) ? "Received Osc Packet [%u]" : "Sent Osc Packet [%u]", static_cast<unsigned int>(packetSize));
+        text = buf;
+        return;
+      }
+      break;
+  }
+
+  char buf[64];
+  sprintf(buf, "message %u [%u bytes]", static_cast<unsigned int>(record.id), static_cast<unsigned int>(record.size));
+  text = buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
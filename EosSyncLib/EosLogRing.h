@@ -0,0 +1,130 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_LOG_RING_H
+#define EOS_LOG_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <string>
+#include <atomic>
+#include <thread>
+
+class EosLogSink;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Fixed-size, lock-free, multiple producer single consumer ring of binary log records.
+// Producers never allocate; when the ring is full the record is dropped and counted.
+// Only one thread may Pop() or Drain() at a time: either the consumer thread started by
+// StartConsumer(), or the host (e.g. EosLog::Flush) while no consumer thread is running.
+// StartConsumer() and StopConsumer() belong to the owner, IsConsumerRunning() may be
+// called from any thread.
+class EosLogRing
+{
+public:
+  enum EnumConstants
+  {
+    DEFAULT_CAPACITY = 4096,  // records, rounded up to a power of two
+    MAX_PAYLOAD_SIZE = 108,   // keeps sRecord at 128 bytes
+    DEFAULT_DRAIN_INTERVAL_MS = 10
+  };
+
+  enum EnumMsgId
+  {
+    MSG_ID_TEXT = 0,  // payload is text, possibly truncated
+    MSG_ID_OSC_RECV,  // payload is uint32_t packet size
+    MSG_ID_OSC_SEND,  // payload is uint32_t packet size
+
+    MSG_ID_USER = 0x1000  // first id available to hosts
+  };
+
+  enum EnumRecordFlags
+  {
+    RECORD_FLAG_TRUNCATED = 0x01
+  };
+
+  struct sRecord
+  {
+    uint32_t id;
+    uint8_t type;  // EosLog::EnumLogMsgType
+    uint8_t flags;
+    uint16_t size;
+    uint32_t reserved;
+    uint64_t timestamp;  // monotonic, microseconds
+    char payload[MAX_PAYLOAD_SIZE];
+  };
+
+  EosLogRing(size_t capacity = DEFAULT_CAPACITY);
+  virtual ~EosLogRing();
+
+  bool Push(uint32_t id, int type, const void *payload, size_t size);
+  bool Pop(sRecord &record);
+  virtual size_t Drain(EosLogSink &sink);
+  virtual size_t GetCapacity() const { return (m_Mask + 1); }
+  virtual size_t GetSize() const;
+  virtual uint64_t GetOverflowCount() const { return m_Overflow.load(std::memory_order_relaxed); }
+  virtual bool StartConsumer(EosLogSink &sink, unsigned int intervalMS = DEFAULT_DRAIN_INTERVAL_MS);
+  virtual void StopConsumer();
+  virtual bool IsConsumerRunning() const { return m_ConsumerRunning.load(); }  // safe from any thread
+  virtual time_t GetWallClockTime(uint64_t timestamp) const;
+
+  static uint64_t GetTimestamp();
+  static void Format(const sRecord &record, std::string &text);
+
+private:
+  struct sCell
+  {
+    std::atomic<size_t> sequence;
+    sRecord record;
+  };
+
+  sCell *m_Cells;
+  size_t m_Mask;
+  std::atomic<size_t> m_EnqueuePos;
+  std::atomic<size_t> m_DequeuePos;  // advanced by the single consumer, read by GetSize()
+  std::atomic<uint64_t> m_Overflow;
+  uint64_t m_StartTimestamp;
+  time_t m_StartTime;
+  std::thread m_ConsumerThread;
+  std::atomic<bool> m_ConsumerRunning;  // set before the thread starts, cleared after it is joined
+  std::atomic<bool> m_ConsumerStop;
+
+  void ConsumerThreadRun(EosLogSink *sink, unsigned int intervalMS);
+
+  // not allowed
+  EosLogRing(const EosLogRing &);
+  EosLogRing &operator=(const EosLogRing &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+class EosLogSink
+{
+public:
+  virtual ~EosLogSink() {}
+  virtual void EosLogSink_Recv(const EosLogRing &ring, const EosLogRing::sRecord &record) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,239 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosMemoryResource.h"
+#include <stdint.h>
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosMemoryResource &EosMemoryResource::GetDefault()
+{
+  static EosNewDeleteResource sDefault;
+  return sDefault;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void *EosNewDeleteResource::Allocate(size_t size, size_t alignment)
+{
+  // operator new is aligned for any fundamental type, two pointers on common platforms
+  if (alignment <= (sizeof(void *) * 2))
+    return ::operator new(size);
+
+  // over-align, original pointer stored just before the returned address
+  char *p = static_cast<char *>(::operator new(size + alignment + sizeof(void *)));
+  uintptr_t aligned = ((reinterpret_cast<uintptr_t>(p) + sizeof(void *) + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1));
+  reinterpret_cast<void **>(aligned)[-1] = p;
+  return reinterpret_cast<void *>(aligned);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosNewDeleteResource::Deallocate(void *p, size_t /*size*/, size_t alignment)
+{
+  if (!p)
+    return;
+
+  if (alignment <= (sizeof(void *) * 2))
+    ::operator delete(p);
+  else
+    ::operator delete(static_cast<void **>(p)[-1]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosPoolResource::EosPoolResource(EosMemoryResource *upstream, size_t blockSize)
+  : m_Upstream(upstream ? upstream : (&EosMemoryResource::GetDefault()))
+  , m_BlockSize((blockSize < MAX_POOLED_SIZE) ? static_cast<size_t>(MAX_POOLED_SIZE) : blockSize)
+  , m_BlockUsed(0)
+  , m_Large(0)
+  , m_NumAllocations(0)
+{
+  for (unsigned int i = 0; i < NUM_SIZE_CLASSES; i++)
+    m_FreeLists[i] = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosPoolResource::~EosPoolResource()
+{
+  Release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void *EosPoolResource::Allocate(size_t size, size_t alignment)
+{
+  int sizeClass = ((alignment <= DEFAULT_ALIGNMENT) ? GetSizeClass(size) : -1);
+  if (sizeClass < 0)
+    return AllocateLarge(size, alignment);
+
+  m_NumAllocations++;
+
+  // reuse freed slot
+  sFreeNode *node = m_FreeLists[sizeClass];
+  if (node)
+  {
+    m_FreeLists[sizeClass] = node->next;
+    return node;
+  }
+
+  // carve from current block
+  size_t classSize = (static_cast<size_t>(MIN_POOLED_SIZE) << sizeClass);
+  if (m_Blocks.empty() || (m_Blocks.back().size - m_BlockUsed) < classSize)
+  {
+    sBlock block;
+    block.size = m_BlockSize;
+    block.data = static_cast<char *>(m_Upstream->Allocate(block.size, DEFAULT_ALIGNMENT));
+    m_Blocks.push_back(block);
+    m_BlockUsed = 0;
+  }
+
+  void *p = &m_Blocks.back().data[m_BlockUsed];
+  m_BlockUsed += classSize;
+  return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPoolResource::Deallocate(void *p, size_t size, size_t alignment)
+{
+  if (!p)
+    return;
+
+  int sizeClass = ((alignment <= DEFAULT_ALIGNMENT) ? GetSizeClass(size) : -1);
+  if (sizeClass < 0)
+  {
+    DeallocateLarge(p, alignment);
+    return;
+  }
+
+  sFreeNode *node = static_cast<sFreeNode *>(p);
+  node->next = m_FreeLists[sizeClass];
+  m_FreeLists[sizeClass] = node;
+  m_NumAllocations--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPoolResource::Release()
+{
+  for (BLOCKS::const_iterator i = m_Blocks.begin(); i != m_Blocks.end(); i++)
+    m_Upstream->Deallocate(i->data, i->size, DEFAULT_ALIGNMENT);
+  m_Blocks.clear();
+  m_BlockUsed = 0;
+
+  while (m_Large)
+  {
+    sLargeHeader *header = m_Large;
+    m_Large = header->next;
+    size_t headerSize = GetLargeHeaderSize(header->alignment);
+    m_Upstream->Deallocate(header, headerSize + header->size, header->alignment);
+  }
+
+  for (unsigned int i = 0; i < NUM_SIZE_CLASSES; i++)
+    m_FreeLists[i] = 0;
+
+  m_NumAllocations = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPoolResource::GetStats(sStats &stats) const
+{
+  stats = sStats();
+
+  stats.numBlocks = m_Blocks.size();
+  for (BLOCKS::const_iterator i = m_Blocks.begin(); i != m_Blocks.end(); i++)
+    stats.blockBytes += i->size;
+
+  for (const sLargeHeader *header = m_Large; header; header = header->next)
+  {
+    stats.numLarge++;
+    stats.largeBytes += header->size;
+  }
+
+  stats.numAllocations = (m_NumAllocations + stats.numLarge);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void *EosPoolResource::AllocateLarge(size_t size, size_t alignment)
+{
+  if (alignment < DEFAULT_ALIGNMENT)
+    alignment = DEFAULT_ALIGNMENT;
+
+  // header sits in front of the allocation so Release() can find it
+  size_t headerSize = GetLargeHeaderSize(alignment);
+  sLargeHeader *header = static_cast<sLargeHeader *>(m_Upstream->Allocate(headerSize + size, alignment));
+  header->prev = 0;
+  header->next = m_Large;
+  header->size = size;
+  header->alignment = alignment;
+  if (m_Large)
+    m_Large->prev = header;
+  m_Large = header;
+
+  return (reinterpret_cast<char *>(header) + headerSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPoolResource::DeallocateLarge(void *p, size_t alignment)
+{
+  if (alignment < DEFAULT_ALIGNMENT)
+    alignment = DEFAULT_ALIGNMENT;
+
+  size_t headerSize = GetLargeHeaderSize(alignment);
+  sLargeHeader *header = reinterpret_cast<sLargeHeader *>(static_cast<char *>(p) - headerSize);
+
+  if (header->prev)
+    header->prev->next = header->next;
+  else
+    m_Large = header->next;
+  if (header->next)
+    header->next->prev = header->prev;
+
+  m_Upstream->Deallocate(header, headerSize + header->size, header->alignment);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int EosPoolResource::GetSizeClass(size_t size)
+{
+  if (size > MAX_POOLED_SIZE)
+    return -1;
+
+  int sizeClass = 0;
+  for (size_t classSize = MIN_POOLED_SIZE; classSize < size; classSize <<= 1)
+    sizeClass++;
+  return sizeClass;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosPoolResource::GetLargeHeaderSize(size_t alignment)
+{
+  // header rounded up so the allocation after it keeps the requested alignment
+  return ((sizeof(sLargeHeader) + (alignment - 1)) & ~(alignment - 1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
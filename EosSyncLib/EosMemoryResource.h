@@ -0,0 +1,177 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_MEMORY_RESOURCE_H
+#define EOS_MEMORY_RESOURCE_H
+
+#include <stddef.h>
+#include <vector>
+
+#if (defined(__cplusplus) && __cplusplus >= 201703L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#define EOS_MEMORY_RESOURCE_PMR
+#include <memory_resource>
+#endif
+#endif
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Allocation interface used for targets, received commands and pooled strings.
+// Hosts may derive their own, or wrap a std::pmr::memory_resource with EosPmrResource.
+class EosMemoryResource
+{
+public:
+  enum EnumConstants
+  {
+    DEFAULT_ALIGNMENT = 16
+  };
+
+  virtual ~EosMemoryResource() {}
+
+  virtual void *Allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT) = 0;
+  virtual void Deallocate(void *p, size_t size, size_t alignment = DEFAULT_ALIGNMENT) = 0;
+
+  static EosMemoryResource &GetDefault();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// global operator new/delete
+class EosNewDeleteResource : public EosMemoryResource
+{
+public:
+  virtual void *Allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+  virtual void Deallocate(void *p, size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Size class slabs carved from large blocks of an upstream resource. Freed memory goes
+// back on its size class free list; Release() hands every block back at once, so owners
+// can drop everything allocated from the pool without freeing it piece by piece.
+// Sizes above MAX_POOLED_SIZE, or alignments above DEFAULT_ALIGNMENT, go to the upstream
+// resource but are still tracked and released by Release().
+class EosPoolResource : public EosMemoryResource
+{
+public:
+  enum EnumConstants
+  {
+    MIN_POOLED_SIZE = 16,    // power of two, at least DEFAULT_ALIGNMENT
+    MAX_POOLED_SIZE = 4096,  // power of two
+    NUM_SIZE_CLASSES = 9,    // MIN_POOLED_SIZE ... MAX_POOLED_SIZE
+    DEFAULT_BLOCK_SIZE = 65536
+  };
+
+  struct sStats
+  {
+    sStats()
+      : numBlocks(0)
+      , blockBytes(0)
+      , numLarge(0)
+      , largeBytes(0)
+      , numAllocations(0)
+    {
+    }
+    size_t numBlocks;
+    size_t blockBytes;
+    size_t numLarge;
+    size_t largeBytes;
+    size_t numAllocations;  // outstanding
+  };
+
+  EosPoolResource(EosMemoryResource *upstream = 0, size_t blockSize = DEFAULT_BLOCK_SIZE);
+  virtual ~EosPoolResource();
+
+  virtual void *Allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+  virtual void Deallocate(void *p, size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+  virtual void Release();
+  virtual EosMemoryResource &GetUpstream() const { return *m_Upstream; }
+  virtual void GetStats(sStats &stats) const;
+
+private:
+  struct sFreeNode
+  {
+    sFreeNode *next;
+  };
+
+  struct sLargeHeader
+  {
+    sLargeHeader *prev;
+    sLargeHeader *next;
+    size_t size;
+    size_t alignment;
+  };
+
+  struct sBlock
+  {
+    char *data;
+    size_t size;
+  };
+
+  typedef std::vector<sBlock> BLOCKS;
+
+  EosMemoryResource *m_Upstream;
+  size_t m_BlockSize;
+  sFreeNode *m_FreeLists[NUM_SIZE_CLASSES];
+  BLOCKS m_Blocks;
+  size_t m_BlockUsed;  // bytes used of the last block
+  sLargeHeader *m_Large;
+  size_t m_NumAllocations;
+
+  virtual void *AllocateLarge(size_t size, size_t alignment);
+  virtual void DeallocateLarge(void *p, size_t alignment);
+
+  static int GetSizeClass(size_t size);
+  static size_t GetLargeHeaderSize(size_t alignment);
+
+  // not allowed
+  EosPoolResource(const EosPoolResource &);
+  EosPoolResource &operator=(const EosPoolResource &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef EOS_MEMORY_RESOURCE_PMR
+
+// forwards to a host provided std::pmr::memory_resource
+class EosPmrResource : public EosMemoryResource
+{
+public:
+  EosPmrResource(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+    : m_Resource(resource)
+  {
+  }
+
+  virtual void *Allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT) { return m_Resource->allocate(size, alignment); }
+  virtual void Deallocate(void *p, size_t size, size_t alignment = DEFAULT_ALIGNMENT) { m_Resource->deallocate(p, size, alignment); }
+  virtual std::pmr::memory_resource *GetResource() const { return m_Resource; }
+
+private:
+  std::pmr::memory_resource *m_Resource;
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -21,7 +21,38 @@
 #include "EosOsc.h"
 #include "EosTcp.h"
 #include "EosLog.h"
+#include "EosLogRing.h"
 #include "EosTimer.h"
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosOsc::sFrame::sFrame(size_t Size, EosMemoryResource &Memory)
+  : data(static_cast<char *>(Memory.Allocate(Size, 1)))
+  , size(Size)
+  , refCount(0)
+  , memory(&Memory)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosOsc::sFrame::~sFrame()
+{
+  memory->Deallocate(data, size, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosOsc::sFrame::release()
+{
+  if (--refCount == 0)
+  {
+    EosMemoryResource *frameMemory = memory;
+    this->~sFrame();
+    frameMemory->Deallocate(this, sizeof(sFrame));
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -29,6 +60,8 @@ EosOsc::sCommand::sCommand()
   : args(0)
   , argCount(0)
   , buf(0)
+  , size(0)
+  , frame(0)
 {
 }
 
@@ -49,21 +82,25 @@ void EosOsc::sCommand::clear()
     args = 0;
   }
 
-  if (buf)
+  if (frame)
   {
-    delete[] buf;
-    buf = 0;
+    frame->release();
+    frame = 0;
   }
 
+  buf = 0;
+  size = 0;
   argCount = 0;
   path.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosOsc::EosOsc(EosLog &log)
+EosOsc::EosOsc(EosLog &log, EosMemoryResource *memory)
   : m_pLog(&log)
+  , m_TraceType(EosLog::LOG_MSG_TYPE_DEBUG)
   , m_SendPacket(0, 0)
+  , m_Pool(memory)
 {
   m_Parser.SetRoot(new OSCMethod());
   memset(&m_InputBuffer, 0, sizeof(m_InputBuffer));
@@ -118,6 +155,43 @@ bool EosOsc::Send(EosTcp &tcp, const OSCPacketWriter &packet, bool immediate)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool EosOsc::Send(EosTcp &tcp, const OSCPreparedPacket &packet, bool immediate)
+{
+  bool success = false;
+
+  if (immediate)
+  {
+    // already framed, send as-is
+    size_t frameSize;
+    const char *frame = packet.GetFrame(frameSize);
+    if (frame && tcp.Send(*m_pLog, frame, frameSize))
+    {
+      TracePacket(EosLog::LOG_MSG_TYPE_SEND, &frame[OSCPreparedPacket::FRAME_HEADER_SIZE], frameSize - OSCPreparedPacket::FRAME_HEADER_SIZE, frameSize);
+      success = true;
+    }
+  }
+  else
+  {
+    // packet may be patched again before the queue is flushed, so queue a copy
+    size_t size;
+    const char *data = packet.GetPacket(size);
+    if (data && size != 0)
+    {
+      char *buf = new char[size];
+      memcpy(buf, data, size);
+      m_Q.push_back(sQueuedPacket(buf, size));
+      success = true;
+    }
+  }
+
+  if (!success && !packet.IsValid())
+    m_pLog->AddError("OSC prepared packet invalid");
+
+  return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void EosOsc::Recv(EosTcp &tcp, unsigned int timeoutMS, CMD_Q &cmdQ)
 {
   size_t size;
@@ -167,30 +241,14 @@ void EosOsc::Recv(EosTcp &tcp, unsigned int timeoutMS, CMD_Q &cmdQ)
         // yup, great success
         char *oscData = &m_InputBuffer.data[sizeof(oscPacketLen)];
 
-        char text[128];
-        sprintf(text, "Received Osc Packet [%d]", static_cast<int>(oscPacketLen));
-        m_pLog->AddDebug(text);
-
-        m_Parser.PrintPacket(*this, oscData, oscPacketLen);
+        TracePacket(EosLog::LOG_MSG_TYPE_RECV, oscData, static_cast<size_t>(oscPacketLen), static_cast<size_t>(oscPacketLen));
 
-        sCommand *cmd = new sCommand;
-
-        cmd->buf = new char[oscPacketLen];
-        memcpy(cmd->buf, oscData, oscPacketLen);
-
-        // find osc path null terminator
-        for (int32_t i = 0; i < oscPacketLen; i++)
-        {
-          if (cmd->buf[i] == 0)
-          {
-            cmd->path = cmd->buf;
-            cmd->argCount = 0xffffffff;
-            cmd->args = OSCArgument::GetArgs(cmd->buf, static_cast<size_t>(oscPacketLen), cmd->argCount);
-            break;
-          }
-        }
-
-        cmdQ.push(cmd);
+        // one copy per frame, bundled messages are views into it
+        sFrame *frame = new (m_Pool.Allocate(sizeof(sFrame))) sFrame(static_cast<size_t>(oscPacketLen), m_Pool);
+        memcpy(frame->data, oscData, frame->size);
+        frame->refCount++;
+        UnpackPacket(*frame, frame->data, frame->size, /*depth*/ 0, cmdQ);
+        frame->release();
 
         // shift away processed data
         m_InputBuffer.size -= totalSize;
@@ -247,11 +305,7 @@ bool EosOsc::SendPacket(EosTcp &tcp, char *data, size_t size)
 
     if (tcp.Send(*m_pLog, m_SendPacket.data, totalSize))
     {
-      char text[128];
-      sprintf(text, "Sent Osc Packet [%d]", static_cast<int>(totalSize));
-      m_pLog->AddDebug(text);
-      m_Parser.PrintPacket(*this, data, size);
-
+      TracePacket(EosLog::LOG_MSG_TYPE_SEND, data, size, totalSize);
       success = true;
     }
 
@@ -263,9 +317,106 @@ bool EosOsc::SendPacket(EosTcp &tcp, char *data, size_t size)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void EosOsc::UnpackPacket(sFrame &frame, char *buf, size_t size, unsigned int depth, CMD_Q &cmdQ)
+{
+  static const size_t OSC_BUNDLE_PREFIX_SIZE = (strlen(OSCParser::OSC_BUNDLE_PREFIX) + 1);
+  if (size >= OSC_BUNDLE_PREFIX_SIZE && memcmp(buf, OSCParser::OSC_BUNDLE_PREFIX, OSC_BUNDLE_PREFIX_SIZE) == 0)
+  {
+    if (depth >= MAX_BUNDLE_DEPTH)
+    {
+      m_pLog->AddError("ignored OSC bundle, nested too deeply");
+      return;
+    }
+
+    // skip past bundle prefix and time tag
+    static const size_t OSC_BUNDLE_HEADER_SIZE = (OSC_BUNDLE_PREFIX_SIZE + 8);
+    if (size < OSC_BUNDLE_HEADER_SIZE)
+    {
+      m_pLog->AddError("ignored malformed OSC bundle");
+      return;
+    }
+
+    buf += OSC_BUNDLE_HEADER_SIZE;
+    size -= OSC_BUNDLE_HEADER_SIZE;
+
+    // bundle elements, each prefixed with an int32 size
+    while (size >= sizeof(int32_t))
+    {
+      int32_t elementSize = OSCArgument::GetInt32FromBuf(buf);
+      buf += sizeof(int32_t);
+      size -= sizeof(int32_t);
+
+      if (elementSize < 0 || static_cast<size_t>(elementSize) > size)
+      {
+        char text[128];
+        sprintf(text, "ignored malformed OSC bundle element [%d], only %u bytes remaining", static_cast<int>(elementSize), static_cast<unsigned int>(size));
+        m_pLog->AddError(text);
+        return;
+      }
+
+      if (elementSize != 0)
+        UnpackPacket(frame, buf, static_cast<size_t>(elementSize), depth + 1, cmdQ);
+
+      buf += elementSize;
+      size -= static_cast<size_t>(elementSize);
+    }
+  }
+  else
+  {
+    sCommand *cmd = new (m_Pool.Allocate(sizeof(sCommand))) sCommand;
+    cmd->frame = &frame;
+    frame.refCount++;
+    cmd->buf = buf;
+    cmd->size = size;
+
+    // find osc path null terminator
+    for (size_t i = 0; i < size; i++)
+    {
+      if (buf[i] == 0)
+      {
+        cmd->path = buf;
+        cmd->argCount = 0xffffffff;
+        cmd->args = OSCArgument::GetArgs(buf, size, cmd->argCount);
+        break;
+      }
+    }
+
+    cmdQ.push(cmd);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosOsc::FreeCommand(sCommand *cmd)
+{
+  if (cmd)
+  {
+    cmd->~sCommand();
+    m_Pool.Deallocate(cmd, sizeof(sCommand));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosOsc::TracePacket(EosLog::EnumLogMsgType type, const char *buf, size_t size, size_t totalSize)
+{
+  // check before formatting, printing a packet copies and re-parses it
+  if (m_pLog->IsEnabled(type))
+  {
+    uint32_t packetSize = static_cast<uint32_t>(totalSize);
+    m_pLog->AddRecord(type, (type == EosLog::LOG_MSG_TYPE_RECV) ? EosLogRing::MSG_ID_OSC_RECV : EosLogRing::MSG_ID_OSC_SEND, &packetSize, sizeof(packetSize));
+
+    m_TraceType = type;
+    m_Parser.PrintPacket(*this, buf, size);
+    m_TraceType = EosLog::LOG_MSG_TYPE_DEBUG;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void EosOsc::OSCParserClient_Log(const std::string &message)
 {
-  m_pLog->AddDebug(message);
+  m_pLog->Add(m_TraceType, message);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -26,11 +26,18 @@
 #include "OSCParser.h"
 #endif
 
+#ifndef EOS_LOG_H
+#include "EosLog.h"
+#endif
+
+#ifndef EOS_MEMORY_RESOURCE_H
+#include "EosMemoryResource.h"
+#endif
+
 #include <vector>
 #include <queue>
 
 class EosTcp;
-class EosLog;
 class EosTimer;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,6 +45,23 @@ class EosTimer;
 class EosOsc : public OSCParserClient
 {
 public:
+  enum EnumConstants
+  {
+    MAX_BUNDLE_DEPTH = 8
+  };
+
+  // one received frame, shared by every command unpacked from it
+  struct sFrame
+  {
+    sFrame(size_t Size, EosMemoryResource &Memory);
+    ~sFrame();
+    void release();  // destroys the frame once unreferenced
+    char *data;
+    size_t size;
+    unsigned int refCount;
+    EosMemoryResource *memory;  // frame and data allocated from here
+  };
+
   struct sCommand
   {
     sCommand();
@@ -46,16 +70,20 @@ public:
     std::string path;
     OSCArgument *args;
     size_t argCount;
-    char *buf;
+    char *buf;     // view into frame
+    size_t size;   // size of this message within frame
+    sFrame *frame;
   };
 
   typedef std::queue<sCommand *> CMD_Q;
 
-  EosOsc(EosLog &log);
+  EosOsc(EosLog &log, EosMemoryResource *memory = 0);
   ~EosOsc();
 
   bool Send(EosTcp &tcp, const OSCPacketWriter &packet, bool immediate);
+  bool Send(EosTcp &tcp, const OSCPreparedPacket &packet, bool immediate);
   void Recv(EosTcp &tcp, unsigned int timeoutMS, CMD_Q &cmdQ);
+  void FreeCommand(sCommand *cmd);
   void Tick(EosTcp &tcp);
   void OSCParserClient_Log(const std::string &message);
   void OSCParserClient_Send(const char * /*buf*/, size_t /*size*/) {}
@@ -84,10 +112,14 @@ private:
   OSCParser m_Parser;
   Q m_Q;
   EosLog *m_pLog;
+  EosLog::EnumLogMsgType m_TraceType;
   sQueuedPacket m_SendPacket;
   sInputBuffer m_InputBuffer;
+  EosPoolResource m_Pool;  // received commands and frames
 
   virtual bool SendPacket(EosTcp &tcp, char *data, size_t size);
+  virtual void TracePacket(EosLog::EnumLogMsgType type, const char *buf, size_t size, size_t totalSize);
+  virtual void UnpackPacket(sFrame &frame, char *buf, size_t size, unsigned int depth, CMD_Q &cmdQ);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
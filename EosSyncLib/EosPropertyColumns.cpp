@@ -0,0 +1,526 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosPropertyColumns.h"
+
+#ifndef OSC_PARSER_H
+#include "OSCParser.h"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosPropertyColumns::ROW EosPropertyColumns::INVALID_ROW;
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosPropertyColumns::EosPropertyColumns(unsigned int numGroups, EosStringPool *stringPool)
+  : m_Groups(numGroups)
+  , m_StringPool(stringPool ? stringPool : (new EosStringPool()))
+  , m_OwnsStringPool(stringPool == 0)
+  , m_NumRows(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosPropertyColumns::~EosPropertyColumns()
+{
+  Clear();
+
+  if (m_OwnsStringPool)
+    delete m_StringPool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPropertyColumns::Clear()
+{
+  for (GROUP_COLUMNS::iterator i = m_Groups.begin(); i != m_Groups.end(); i++)
+  {
+    COLUMNS &columns = *i;
+    for (COLUMNS::iterator j = columns.begin(); j != columns.end(); j++)
+    {
+      sColumn &column = *j;
+      for (ROW row = 0; row < column.types.size(); row++)
+        ReleaseCell(column, row);
+    }
+    columns.clear();
+  }
+  m_FreeRows.clear();
+  m_NumRows = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosPropertyColumns::ROW EosPropertyColumns::AddRow()
+{
+  if (!m_FreeRows.empty())
+  {
+    ROW row = m_FreeRows.back();
+    m_FreeRows.pop_back();
+    return row;
+  }
+
+  return static_cast<ROW>(m_NumRows++);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPropertyColumns::RemoveRow(ROW row)
+{
+  if (row < m_NumRows)
+  {
+    ClearRow(row);
+    m_FreeRows.push_back(row);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPropertyColumns::ClearRow(ROW row)
+{
+  for (GROUP_COLUMNS::iterator i = m_Groups.begin(); i != m_Groups.end(); i++)
+  {
+    COLUMNS &columns = *i;
+    for (COLUMNS::iterator j = columns.begin(); j != columns.end(); j++)
+    {
+      sColumn &column = *j;
+      if (row < column.types.size())
+        ReleaseCell(column, row);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosPropertyColumns::GetNumColumns(unsigned int groupSlot) const
+{
+  return ((groupSlot < m_Groups.size()) ? m_Groups[groupSlot].size() : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosPropertyColumns::sColumn *EosPropertyColumns::GetColumn(unsigned int groupSlot, unsigned int propIndex) const
+{
+  if (groupSlot < m_Groups.size())
+  {
+    const COLUMNS &columns = m_Groups[groupSlot];
+    if (propIndex < columns.size())
+      return &columns[propIndex];
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::SetValue(ROW row, unsigned int groupSlot, unsigned int propIndex, const OSCArgument &arg)
+{
+  if (row >= m_NumRows || groupSlot >= m_Groups.size())
+    return false;
+
+  uCell cell;
+  memset(&cell, 0, sizeof(cell));
+  EnumColumnType type = COLUMN_TYPE_NONE;
+
+  switch (arg.GetType())
+  {
+    case OSCArgument::OSC_TYPE_CHAR:
+    case OSCArgument::OSC_TYPE_INT32:
+    {
+      int n;
+      if (arg.GetInt(n))
+      {
+        cell.n = n;
+        type = COLUMN_TYPE_INT32;
+      }
+    }
+    break;
+
+    case OSCArgument::OSC_TYPE_FLOAT32:
+    case OSCArgument::OSC_TYPE_FLOAT64:
+    {
+      if (arg.GetDouble(cell.f))
+        type = COLUMN_TYPE_FLOAT;
+    }
+    break;
+
+    case OSCArgument::OSC_TYPE_STRING:
+    {
+      // kept as text even when numeric, e.g. a label "10", numeric getters parse it
+      const char *s = arg.GetRaw();
+      if (s)
+      {
+        cell.id = m_StringPool->Intern(s, strlen(s));
+        type = COLUMN_TYPE_STRING;
+      }
+    }
+    break;
+
+    case OSCArgument::OSC_TYPE_BLOB:
+    {
+      const char *buf = arg.GetRaw();
+      if (buf && arg.GetSize() >= sizeof(int32_t))
+      {
+        size_t size = static_cast<size_t>(OSCArgument::GetInt32FromBuf(buf));
+        if (size <= (arg.GetSize() - sizeof(int32_t)))
+        {
+          cell.id = m_StringPool->Intern(&buf[sizeof(int32_t)], size);
+          type = COLUMN_TYPE_BLOB;
+        }
+      }
+    }
+    break;
+
+    default:
+    {
+      // rarely used types keep the text the string storage would have
+      std::string str;
+      if (arg.GetString(str))
+      {
+        cell.id = m_StringPool->Intern(str.c_str(), str.size());
+        type = COLUMN_TYPE_STRING;
+      }
+    }
+    break;
+  }
+
+  if (type == COLUMN_TYPE_NONE)
+  {
+    // unreadable value, store an empty string like the string storage would
+    cell.id = m_StringPool->Intern("", 0);
+    type = COLUMN_TYPE_STRING;
+  }
+
+  COLUMNS &columns = m_Groups[groupSlot];
+  if (propIndex >= columns.size())
+    columns.resize(propIndex + 1);
+
+  sColumn &column = columns[propIndex];
+  if (row >= column.cells.size())
+  {
+    column.cells.resize(m_NumRows);
+    column.types.resize(m_NumRows, COLUMN_TYPE_NONE);
+  }
+
+  ReleaseCell(column, row);
+  column.cells[row] = cell;
+  column.types[row] = static_cast<uint8_t>(type);
+
+  if (column.type == COLUMN_TYPE_NONE)
+    column.type = type;
+  else if (column.type != type)
+    column.type = COLUMN_TYPE_MIXED;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosPropertyColumns::uCell *EosPropertyColumns::GetCell(ROW row, unsigned int groupSlot, unsigned int propIndex, EnumColumnType &type) const
+{
+  const sColumn *column = GetColumn(groupSlot, propIndex);
+  if (column && row < column->types.size())
+  {
+    type = static_cast<EnumColumnType>(column->types[row]);
+    if (type != COLUMN_TYPE_NONE)
+      return &column->cells[row];
+  }
+
+  type = COLUMN_TYPE_NONE;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosPropertyColumns::EnumColumnType EosPropertyColumns::GetType(ROW row, unsigned int groupSlot, unsigned int propIndex) const
+{
+  EnumColumnType type;
+  GetCell(row, groupSlot, propIndex, type);
+  return type;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetInt(ROW row, unsigned int groupSlot, unsigned int propIndex, int &n) const
+{
+  EnumColumnType type;
+  const uCell *cell = GetCell(row, groupSlot, propIndex, type);
+  if (cell)
+  {
+    switch (type)
+    {
+      case COLUMN_TYPE_INT32: n = cell->n; return true;
+
+      case COLUMN_TYPE_FLOAT: n = OSC_ROUND(cell->f); return true;
+
+      case COLUMN_TYPE_STRING: return GetIntFromString(m_StringPool->GetString(cell->id), n);
+
+      default: return false;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetDecimal(ROW row, unsigned int groupSlot, unsigned int propIndex, int64_t &n) const
+{
+  EnumColumnType type;
+  const uCell *cell = GetCell(row, groupSlot, propIndex, type);
+  if (cell)
+  {
+    switch (type)
+    {
+      case COLUMN_TYPE_INT32: n = (static_cast<int64_t>(cell->n) * DECIMAL_SCALE); return true;
+
+      case COLUMN_TYPE_FLOAT: n = OSC_ROUND64(cell->f * DECIMAL_SCALE); return true;
+
+      case COLUMN_TYPE_STRING: return GetDecimalFromString(m_StringPool->GetString(cell->id), n);
+
+      default: return false;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetDouble(ROW row, unsigned int groupSlot, unsigned int propIndex, double &d) const
+{
+  EnumColumnType type;
+  const uCell *cell = GetCell(row, groupSlot, propIndex, type);
+  if (cell)
+  {
+    switch (type)
+    {
+      case COLUMN_TYPE_INT32: d = cell->n; return true;
+
+      case COLUMN_TYPE_FLOAT: d = cell->f; return true;
+
+      case COLUMN_TYPE_STRING: return GetDoubleFromString(m_StringPool->GetString(cell->id), d);
+
+      default: return false;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *EosPropertyColumns::GetString(ROW row, unsigned int groupSlot, unsigned int propIndex) const
+{
+  EnumColumnType type;
+  const uCell *cell = GetCell(row, groupSlot, propIndex, type);
+  return ((cell && type == COLUMN_TYPE_STRING) ? m_StringPool->GetString(cell->id) : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetString(ROW row, unsigned int groupSlot, unsigned int propIndex, std::string &str) const
+{
+  str.clear();
+
+  EnumColumnType type;
+  const uCell *cell = GetCell(row, groupSlot, propIndex, type);
+  if (cell)
+  {
+    // same text OSCArgument::GetString produced for the original value
+    switch (type)
+    {
+      case COLUMN_TYPE_INT32:
+      {
+        char buf[33];
+        snprintf(buf, sizeof(buf), "%d", cell->n);
+        str = buf;
+      }
+      return true;
+
+      case COLUMN_TYPE_FLOAT:
+      {
+        char buf[512];
+        snprintf(buf, sizeof(buf), "%.3f", cell->f);
+        str = buf;
+      }
+      return true;
+
+      case COLUMN_TYPE_STRING: str.assign(m_StringPool->GetString(cell->id), m_StringPool->GetSize(cell->id)); return true;
+
+      default: return false;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *EosPropertyColumns::GetBlob(ROW row, unsigned int groupSlot, unsigned int propIndex, size_t &size) const
+{
+  EnumColumnType type;
+  const uCell *cell = GetCell(row, groupSlot, propIndex, type);
+  if (cell && type == COLUMN_TYPE_BLOB)
+  {
+    size = m_StringPool->GetSize(cell->id);
+    return m_StringPool->GetString(cell->id);
+  }
+
+  size = 0;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosPropertyColumns::GetMemoryUsage() const
+{
+  size_t size = sizeof(*this);
+
+  for (GROUP_COLUMNS::const_iterator i = m_Groups.begin(); i != m_Groups.end(); i++)
+  {
+    const COLUMNS &columns = *i;
+    size += (columns.capacity() * sizeof(sColumn));
+    for (COLUMNS::const_iterator j = columns.begin(); j != columns.end(); j++)
+      size += ((j->cells.capacity() * sizeof(uCell)) + j->types.capacity());
+  }
+
+  size += (m_FreeRows.capacity() * sizeof(ROW));
+
+  return size;  // string and blob bytes are accounted for by the string pool
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPropertyColumns::ReleaseCell(sColumn &column, ROW row)
+{
+  switch (column.types[row])
+  {
+    case COLUMN_TYPE_STRING:
+    case COLUMN_TYPE_BLOB: m_StringPool->Release(column.cells[row].id); break;
+  }
+
+  column.types[row] = COLUMN_TYPE_NONE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetIntFromString(const char *str, int &n)
+{
+  if (str && OSCArgument::IsIntString(str))
+  {
+    n = atoi(str);
+    return true;
+  }
+  else if (str && OSCArgument::IsFloatString(str))
+  {
+    n = OSC_ROUND(atof(str));
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetDecimalFromString(const char *str, int64_t &n)
+{
+  if (!str)
+    return false;
+
+  // [-]<whole>[.<decimal>] with up to DECIMAL_DIGITS decimal digits is exact,
+  // anything else numeric is rounded
+  if (GetFixedPointFromString(str, n))
+    return true;
+  else if (OSCArgument::IsFloatString(str))
+  {
+    n = OSC_ROUND64(atof(str) * DECIMAL_SCALE);
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetDoubleFromString(const char *str, double &d)
+{
+  if (str && OSCArgument::IsFloatString(str))
+  {
+    d = atof(str);
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPropertyColumns::GetFixedPointFromString(const char *str, int64_t &n)
+{
+  const char *p = str;
+  bool negative = false;
+  if (*p == '-')
+  {
+    negative = true;
+    p++;
+  }
+
+  const char *wholeStart = p;
+  int64_t whole = 0;
+  for (; *p >= '0' && *p <= '9'; p++)
+  {
+    if ((p - wholeStart) >= MAX_DECIMAL_WHOLE_DIGITS)
+      return false;  // too large
+    whole = ((whole * 10) + (*p - '0'));
+  }
+
+  size_t wholeDigits = static_cast<size_t>(p - wholeStart);
+
+  int64_t decimal = 0;
+  size_t decimalDigits = 0;
+  if (*p == '.')
+  {
+    for (p++; *p >= '0' && *p <= '9'; p++)
+    {
+      if (++decimalDigits > DECIMAL_DIGITS)
+        return false;  // more precision than we keep
+      decimal = ((decimal * 10) + (*p - '0'));
+    }
+
+    if (decimalDigits == 0)
+      return false;
+  }
+
+  if (*p != 0 || wholeDigits == 0)
+    return false;
+
+  for (size_t i = decimalDigits; i < DECIMAL_DIGITS; i++)
+    decimal *= 10;
+
+  n = ((whole * DECIMAL_SCALE) + decimal);
+  if (negative)
+    n = -n;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,134 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_PROPERTY_COLUMNS_H
+#define EOS_PROPERTY_COLUMNS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#ifndef EOS_STRING_POOL_H
+#include "EosStringPool.h"
+#endif
+
+class OSCArgument;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Typed, per-list property storage. Each property (group slot, property index) is a
+// column of 8-byte cells indexed by row, one row per target. String and blob cells
+// hold references into an EosStringPool, usually shared by every list of a show.
+class EosPropertyColumns
+{
+public:
+  enum EnumColumnType
+  {
+    COLUMN_TYPE_NONE = 0,  // no value
+    COLUMN_TYPE_INT32,     // int
+    COLUMN_TYPE_FLOAT,     // double
+    COLUMN_TYPE_STRING,    // interned, numeric text included
+    COLUMN_TYPE_BLOB,      // interned raw bytes
+
+    COLUMN_TYPE_MIXED  // column only, cells differ in type
+  };
+
+  enum EnumConstants
+  {
+    DECIMAL_SCALE = 1000,
+    DECIMAL_DIGITS = 3,
+    MAX_DECIMAL_WHOLE_DIGITS = 15
+  };
+
+  typedef unsigned int ROW;
+
+  static const ROW INVALID_ROW = 0xffffffff;
+
+  union uCell
+  {
+    int32_t n;
+    double f;
+    EosStringPool::HANDLE id;  // string or blob
+  };
+
+  struct sColumn
+  {
+    sColumn()
+      : type(COLUMN_TYPE_NONE)
+    {
+    }
+    EnumColumnType type;  // type shared by all cells, or COLUMN_TYPE_MIXED
+    std::vector<uCell> cells;
+    std::vector<uint8_t> types;  // EnumColumnType per cell
+  };
+
+  EosPropertyColumns(unsigned int numGroups, EosStringPool *stringPool = 0);
+  virtual ~EosPropertyColumns();
+
+  virtual void Clear();
+  virtual ROW AddRow();
+  virtual void RemoveRow(ROW row);
+  virtual void ClearRow(ROW row);
+  virtual size_t GetNumRows() const { return m_NumRows; }
+  virtual size_t GetNumColumns(unsigned int groupSlot) const;
+  virtual const sColumn *GetColumn(unsigned int groupSlot, unsigned int propIndex) const;
+  virtual bool SetValue(ROW row, unsigned int groupSlot, unsigned int propIndex, const OSCArgument &arg);
+  virtual EnumColumnType GetType(ROW row, unsigned int groupSlot, unsigned int propIndex) const;
+  virtual bool IsSet(ROW row, unsigned int groupSlot, unsigned int propIndex) const { return (GetType(row, groupSlot, propIndex) != COLUMN_TYPE_NONE); }
+  virtual bool GetInt(ROW row, unsigned int groupSlot, unsigned int propIndex, int &n) const;
+  virtual bool GetDecimal(ROW row, unsigned int groupSlot, unsigned int propIndex, int64_t &n) const;  // fixed-point, value * DECIMAL_SCALE
+  virtual bool GetDouble(ROW row, unsigned int groupSlot, unsigned int propIndex, double &d) const;
+  virtual const char *GetString(ROW row, unsigned int groupSlot, unsigned int propIndex) const;
+  virtual bool GetString(ROW row, unsigned int groupSlot, unsigned int propIndex, std::string &str) const;
+  virtual const char *GetBlob(ROW row, unsigned int groupSlot, unsigned int propIndex, size_t &size) const;
+  virtual size_t GetMemoryUsage() const;
+  virtual const EosStringPool &GetStringPool() const { return *m_StringPool; }
+
+  // numeric text parsed the same way for string and column storage
+  static bool GetIntFromString(const char *str, int &n);
+  static bool GetDecimalFromString(const char *str, int64_t &n);
+  static bool GetDoubleFromString(const char *str, double &d);
+
+private:
+  typedef std::vector<sColumn> COLUMNS;
+  typedef std::vector<COLUMNS> GROUP_COLUMNS;
+  typedef std::vector<ROW> ROWS;
+
+  GROUP_COLUMNS m_Groups;
+  EosStringPool *m_StringPool;
+  bool m_OwnsStringPool;
+  ROWS m_FreeRows;
+  size_t m_NumRows;
+
+  virtual const uCell *GetCell(ROW row, unsigned int groupSlot, unsigned int propIndex, EnumColumnType &type) const;
+  virtual void ReleaseCell(sColumn &column, ROW row);
+
+  static bool GetFixedPointFromString(const char *str, int64_t &n);  // exact, up to DECIMAL_DIGITS decimal digits
+
+  // not allowed
+  EosPropertyColumns(const EosPropertyColumns &);
+  EosPropertyColumns &operator=(const EosPropertyColumns &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,346 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosStringPool.h"
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosStringPool::HANDLE EosStringPool::INVALID_HANDLE;
+const EosStringPool::HANDLE EosStringPool::INDEX_EMPTY;
+const EosStringPool::HANDLE EosStringPool::INDEX_REMOVED;
+const uint32_t EosStringPool::NO_BLOCK;
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosStringPool::EosStringPool(size_t blockSize, EosMemoryResource *memory)
+  : m_BlockSize(blockSize)
+  , m_Memory(memory ? memory : (&EosMemoryResource::GetDefault()))
+  , m_IndexUsed(0)
+  , m_CurrentBlock(NO_BLOCK)
+  , m_NumStrings(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosStringPool::~EosStringPool()
+{
+  FreeBlocks();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosStringPool::Clear()
+{
+  m_Entries.clear();
+  m_FreeEntries.clear();
+  m_Index.clear();
+  m_IndexUsed = 0;
+  m_NumStrings = 0;
+  FreeBlocks();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosStringPool::HANDLE EosStringPool::Intern(const char *buf, size_t size)
+{
+  if (!buf)
+  {
+    if (size != 0)
+      return INVALID_HANDLE;
+    buf = "";
+  }
+
+  // keep load factor (including removed slots) under 3/4
+  if (((m_IndexUsed + 1) * 4) > (m_Index.size() * 3))
+  {
+    size_t indexSize = MIN_INDEX_SIZE;
+    while ((m_NumStrings + 1) * 2 > indexSize)
+      indexSize <<= 1;
+    Rehash(indexSize);
+  }
+
+  uint32_t hash = Hash(buf, size);
+  size_t mask = (m_Index.size() - 1);
+  size_t insertAt = m_Index.size();
+  for (size_t i = (hash & mask);; i = ((i + 1) & mask))
+  {
+    HANDLE handle = m_Index[i];
+    if (handle == INDEX_EMPTY)
+    {
+      if (insertAt == m_Index.size())
+      {
+        insertAt = i;
+        m_IndexUsed++;
+      }
+      break;
+    }
+    else if (handle == INDEX_REMOVED)
+    {
+      if (insertAt == m_Index.size())
+        insertAt = i;
+    }
+    else
+    {
+      sEntry &entry = m_Entries[handle];
+      if (entry.hash == hash && entry.size == size && memcmp(entry.data, buf, size) == 0)
+      {
+        entry.refCount++;
+        return handle;
+      }
+    }
+  }
+
+  uint32_t block = 0;
+  char *data = Allocate(size + 1, block);
+  if (size != 0)
+    memcpy(data, buf, size);
+  data[size] = 0;
+
+  HANDLE handle;
+  if (m_FreeEntries.empty())
+  {
+    handle = static_cast<HANDLE>(m_Entries.size());
+    m_Entries.push_back(sEntry());
+  }
+  else
+  {
+    handle = m_FreeEntries.back();
+    m_FreeEntries.pop_back();
+  }
+
+  sEntry &entry = m_Entries[handle];
+  entry.data = data;
+  entry.size = static_cast<uint32_t>(size);
+  entry.refCount = 1;
+  entry.hash = hash;
+  entry.block = block;
+
+  m_Index[insertAt] = handle;
+  m_NumStrings++;
+  return handle;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosStringPool::AddRef(HANDLE handle)
+{
+  if (handle < m_Entries.size() && m_Entries[handle].refCount != 0)
+    m_Entries[handle].refCount++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosStringPool::Release(HANDLE handle)
+{
+  if (handle >= m_Entries.size())
+    return;
+
+  sEntry &entry = m_Entries[handle];
+  if (entry.refCount == 0 || --entry.refCount != 0)
+    return;
+
+  // remove from index
+  size_t mask = (m_Index.size() - 1);
+  for (size_t i = (entry.hash & mask); m_Index[i] != INDEX_EMPTY; i = ((i + 1) & mask))
+  {
+    if (m_Index[i] == handle)
+    {
+      m_Index[i] = INDEX_REMOVED;
+      break;
+    }
+  }
+
+  entry.data = 0;
+  entry.size = 0;
+  m_FreeEntries.push_back(handle);
+  ReleaseBlock(entry.block);
+
+  if (--m_NumStrings == 0)
+  {
+    // nothing references the arena anymore
+    m_Entries.clear();
+    m_FreeEntries.clear();
+    m_Index.clear();
+    m_IndexUsed = 0;
+    FreeBlocks();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *EosStringPool::GetString(HANDLE handle) const
+{
+  return ((handle < m_Entries.size()) ? m_Entries[handle].data : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosStringPool::GetSize(HANDLE handle) const
+{
+  return ((handle < m_Entries.size()) ? m_Entries[handle].size : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosStringPool::GetStats(sStats &stats) const
+{
+  stats = sStats();
+
+  for (ENTRIES::const_iterator i = m_Entries.begin(); i != m_Entries.end(); i++)
+  {
+    const sEntry &entry = *i;
+    if (entry.refCount != 0)
+    {
+      stats.numStrings++;
+      stats.numReferences += entry.refCount;
+      stats.uniqueBytes += (entry.size + 1);
+      // a std::string per reference, plus its heap buffer when it does not fit inline
+      size_t copySize = sizeof(std::string);
+      if (entry.size >= sizeof(std::string) / 2)
+        copySize += (entry.size + 1);
+      stats.referencedBytes += (copySize * entry.refCount);
+    }
+  }
+
+  for (BLOCKS::const_iterator i = m_Blocks.begin(); i != m_Blocks.end(); i++)
+    stats.poolBytes += i->size;
+  stats.poolBytes += (m_Entries.capacity() * sizeof(sEntry));
+  stats.poolBytes += (m_FreeEntries.capacity() * sizeof(HANDLE));
+  stats.poolBytes += (m_Index.capacity() * sizeof(HANDLE));
+  stats.poolBytes += (stats.numReferences * sizeof(HANDLE));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t EosStringPool::Hash(const char *buf, size_t size)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= static_cast<uint8_t>(buf[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+char *EosStringPool::Allocate(size_t size, uint32_t &block)
+{
+  if (m_CurrentBlock < m_Blocks.size())
+  {
+    sBlock &current = m_Blocks[m_CurrentBlock];
+    if ((current.size - current.used) >= size)
+    {
+      char *p = &current.data[current.used];
+      current.used += size;
+      current.numStrings++;
+      block = m_CurrentBlock;
+      return p;
+    }
+  }
+
+  // reuse a freed slot so entry block indices stay valid
+  size_t slot = 0;
+  while (slot < m_Blocks.size() && m_Blocks[slot].data)
+    slot++;
+  if (slot == m_Blocks.size())
+    m_Blocks.push_back(sBlock());
+
+  sBlock &newBlock = m_Blocks[slot];
+  newBlock.size = ((size > m_BlockSize) ? size : m_BlockSize);
+  newBlock.data = static_cast<char *>(m_Memory->Allocate(newBlock.size, 1));
+  newBlock.used = size;
+  newBlock.numStrings = 1;
+
+  // oversized string gets its own block, keep filling the current one
+  if (size <= m_BlockSize || m_CurrentBlock == NO_BLOCK)
+    m_CurrentBlock = static_cast<uint32_t>(slot);
+
+  block = static_cast<uint32_t>(slot);
+  return newBlock.data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosStringPool::ReleaseBlock(uint32_t block)
+{
+  if (block >= m_Blocks.size())
+    return;
+
+  sBlock &b = m_Blocks[block];
+  if (b.numStrings == 0 || --b.numStrings != 0)
+    return;
+
+  if (block == m_CurrentBlock && b.size == m_BlockSize)
+  {
+    // keep filling it from the start
+    b.used = 0;
+  }
+  else
+  {
+    m_Memory->Deallocate(b.data, b.size, 1);
+    b.data = 0;
+    b.size = 0;
+    b.used = 0;
+    if (block == m_CurrentBlock)
+      m_CurrentBlock = NO_BLOCK;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosStringPool::FreeBlocks()
+{
+  for (BLOCKS::const_iterator i = m_Blocks.begin(); i != m_Blocks.end(); i++)
+  {
+    if (i->data)
+      m_Memory->Deallocate(i->data, i->size, 1);
+  }
+  m_Blocks.clear();
+  m_CurrentBlock = NO_BLOCK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosStringPool::Rehash(size_t indexSize)
+{
+  m_Index.assign(indexSize, INDEX_EMPTY);
+  m_IndexUsed = 0;
+
+  size_t mask = (indexSize - 1);
+  for (size_t handle = 0; handle < m_Entries.size(); handle++)
+  {
+    const sEntry &entry = m_Entries[handle];
+    if (entry.refCount != 0)
+    {
+      size_t i = (entry.hash & mask);
+      while (m_Index[i] != INDEX_EMPTY)
+        i = ((i + 1) & mask);
+      m_Index[i] = static_cast<HANDLE>(handle);
+      m_IndexUsed++;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
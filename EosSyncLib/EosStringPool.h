@@ -0,0 +1,135 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_STRING_POOL_H
+#define EOS_STRING_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+#ifndef EOS_MEMORY_RESOURCE_H
+#include "EosMemoryResource.h"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Reference counted intern table. Strings are stored once, null terminated, in
+// arena blocks and looked up through an open addressing hash index.
+// Released strings leave the index immediately; each block counts its live
+// strings and is rewound (current block) or freed (older blocks) once its last
+// string has been released.
+class EosStringPool
+{
+public:
+  enum EnumConstants
+  {
+    DEFAULT_BLOCK_SIZE = 65536,
+    MIN_INDEX_SIZE = 64  // power of two
+  };
+
+  typedef uint32_t HANDLE;
+
+  static const HANDLE INVALID_HANDLE = 0xffffffff;
+
+  struct sStats
+  {
+    sStats()
+      : numStrings(0)
+      , numReferences(0)
+      , uniqueBytes(0)
+      , referencedBytes(0)
+      , poolBytes(0)
+    {
+    }
+    size_t numStrings;       // live unique strings
+    size_t numReferences;    // sum of reference counts
+    size_t uniqueBytes;      // bytes of live strings, stored once
+    size_t referencedBytes;  // bytes if every reference held its own copy
+    size_t poolBytes;        // arena, entry and index memory actually used
+    size_t GetSavedBytes() const { return ((referencedBytes > poolBytes) ? (referencedBytes - poolBytes) : 0); }
+  };
+
+  EosStringPool(size_t blockSize = DEFAULT_BLOCK_SIZE, EosMemoryResource *memory = 0);
+  virtual ~EosStringPool();
+
+  virtual void Clear();
+  virtual HANDLE Intern(const char *buf, size_t size);
+  virtual HANDLE Intern(const char *str) { return Intern(str, str ? strlen(str) : 0); }
+  virtual void AddRef(HANDLE handle);
+  virtual void Release(HANDLE handle);
+  virtual const char *GetString(HANDLE handle) const;
+  virtual size_t GetSize(HANDLE handle) const;
+  virtual size_t GetNumStrings() const { return m_NumStrings; }
+  virtual void GetStats(sStats &stats) const;
+
+  static uint32_t Hash(const char *buf, size_t size);
+
+private:
+  struct sEntry
+  {
+    char *data;
+    uint32_t size;
+    uint32_t refCount;  // 0 when unused
+    uint32_t hash;
+    uint32_t block;  // index into m_Blocks
+  };
+
+  struct sBlock
+  {
+    char *data;  // 0 when the slot is free
+    size_t size;
+    size_t used;
+    size_t numStrings;
+  };
+
+  typedef std::vector<sEntry> ENTRIES;
+  typedef std::vector<HANDLE> HANDLES;
+  typedef std::vector<sBlock> BLOCKS;
+
+  static const HANDLE INDEX_EMPTY = 0xffffffff;
+  static const HANDLE INDEX_REMOVED = 0xfffffffe;
+  static const uint32_t NO_BLOCK = 0xffffffff;
+
+  size_t m_BlockSize;
+  EosMemoryResource *m_Memory;  // arena blocks
+  ENTRIES m_Entries;
+  HANDLES m_FreeEntries;
+  HANDLES m_Index;
+  size_t m_IndexUsed;  // live + removed slots
+  BLOCKS m_Blocks;
+  uint32_t m_CurrentBlock;  // block being filled, NO_BLOCK if none
+  size_t m_NumStrings;
+
+  virtual char *Allocate(size_t size, uint32_t &block);
+  virtual void ReleaseBlock(uint32_t block);
+  virtual void FreeBlocks();
+  virtual void Rehash(size_t indexSize);
+
+  // not allowed
+  EosStringPool(const EosStringPool &);
+  EosStringPool &operator=(const EosStringPool &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
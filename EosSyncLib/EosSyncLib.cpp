@@ -20,14 +20,19 @@
 
 #include "EosSyncLib.h"
 #include "EosTcp.h"
+#include "EosTimer.h"
+#include "EosDataSnapshot.h"
 
 #include <time.h>
+#include <limits.h>
+#include <new>
 #include <set>
+#include <atomic>
+#include <algorithm>
 
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TCP_RECV_TIMEOUT 10
-#define TARGET_DECIMALS 3
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -89,6 +94,35 @@ bool EosTarget::sDecimalNumber::operator<(const sDecimalNumber &other) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+EosTarget::sTargetNumber::sTargetNumber(const sDecimalNumber &num)
+{
+  // the sign of whole applies to decimal, decimal carries the sign when whole is 0
+  int64_t decimal = ((num.decimal < 0) ? -static_cast<int64_t>(num.decimal) : static_cast<int64_t>(num.decimal));
+  if (num.whole < 0 || (num.whole == 0 && num.decimal < 0))
+    value = ((static_cast<int64_t>(num.whole) * NUMBER_SCALE) - decimal);
+  else
+    value = ((static_cast<int64_t>(num.whole) * NUMBER_SCALE) + decimal);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTarget::sTargetNumber EosTarget::sTargetNumber::FromValue(int64_t Value)
+{
+  sTargetNumber num;
+  num.value = Value;
+  return num;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int EosTarget::sTargetNumber::GetDecimal() const
+{
+  int decimal = static_cast<int>(value % NUMBER_SCALE);
+  return (((decimal < 0) && (value <= -NUMBER_SCALE)) ? -decimal : decimal);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool EosTarget::sTargetKey::operator==(const sTargetKey &other) const
 {
   return (num == other.num && part == other.part);
@@ -103,27 +137,54 @@ bool EosTarget::sTargetKey::operator<(const sTargetKey &other) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosTarget::EosTarget(EnumEosTargetType type)
+EosTarget::EosTarget(EnumEosTargetType type, EosPropertyColumns *columns, const sUID &uid)
+  : m_Type(type)
+  , m_UID(uid)
+  , m_Generation(NewGeneration())
+  , m_Revision(0)
+  , m_Version(0)
+  , m_Columns(columns)
+  , m_Row(columns ? columns->AddRow() : EosPropertyColumns::INVALID_ROW)
+  , m_NumPendingGroups(GetNumPropGroups())
+  , m_NumPendingProps(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTarget::~EosTarget()
 {
-  InitializePropGroupsForTargetType(type, m_PropGroups);
+  if (m_Columns)
+    m_Columns->RemoveRow(m_Row);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void EosTarget::Clear()
 {
-  for (PROP_GROUPS::iterator i = m_PropGroups.begin(); i != m_PropGroups.end(); i++)
+  m_Revision++;
+
+  for (unsigned int i = 0; i < MAX_PROP_GROUPS; i++)
   {
-    sPropertyGroup &group = i->second;
+    sPropertyGroup &group = m_PropGroups[i];
     group.props.clear();
+    group.columnCount = 0;
     group.initialized = false;
   }
+
+  if (m_Columns)
+    m_Columns->ClearRow(m_Row);
+
+  m_NumPendingGroups = GetNumPropGroups();
+  m_NumPendingProps = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void EosTarget::Recv(EosLog &log, EosOsc::sCommand &command, const sPathData &pathData)
 {
+  m_Revision++;
+
   switch (m_Status.GetValue())
   {
     case EosSyncStatus::SYNC_STATUS_UNINTIALIZED:
@@ -132,45 +193,76 @@ void EosTarget::Recv(EosLog &log, EosOsc::sCommand &command, const sPathData &pa
 
     case EosSyncStatus::SYNC_STATUS_RUNNING:
     {
-      PROP_GROUPS::iterator i = m_PropGroups.find(pathData.group);
-      if (i != m_PropGroups.end())
+      unsigned int numGroups = GetNumPropGroups();
+      if (pathData.groupSlot >= 0 && static_cast<unsigned int>(pathData.groupSlot) < numGroups)
       {
-        sPropertyGroup &group = i->second;
+        sPropertyGroup &group = m_PropGroups[pathData.groupSlot];
         size_t propOffset = 0;
 
         size_t numProps = (pathData.isList ? pathData.listSize : command.argCount);
+        size_t groupSize = (m_Columns ? group.columnCount : group.props.size());
+        bool resized = (numProps != 0 && numProps != groupSize);
+        if (group.initialized && resized)
+          m_NumPendingProps -= GetNumPendingProps(static_cast<unsigned int>(pathData.groupSlot));
         if (numProps != 0)
-          group.props.resize(numProps);
+        {
+          if (m_Columns)
+            group.columnCount = numProps;
+          else
+            group.props.resize(numProps);
+        }
         if (group.initialized)
         {
-          if (group.props.size() != numProps)
+          if (groupSize != numProps)
           {
             std::string text("invalid reply \"");
             text.append(command.path);
             text.append("\", existing property count ");
             char buf[33];
-            sprintf(buf, "%d", static_cast<int>(group.props.size()));
+            sprintf(buf, "%d", static_cast<int>(groupSize));
             text.append(buf);
             text.append(" does not match new count ");
             sprintf(buf, "%d", static_cast<int>(numProps));
             text.append(buf);
             log.AddError(text);
           }
+
+          if (resized)
+            m_NumPendingProps += GetNumPendingProps(static_cast<unsigned int>(pathData.groupSlot));
         }
         else
+        {
           group.initialized = true;
+          m_NumPendingGroups--;
+          m_NumPendingProps += GetNumPendingProps(static_cast<unsigned int>(pathData.groupSlot));
+        }
 
         if (command.args)
         {
+          groupSize = (m_Columns ? group.columnCount : group.props.size());
           for (size_t j = 0; j < command.argCount; j++)
           {
             size_t propIndex = (propOffset + j);
-            if (propIndex < group.props.size())
+            if (propIndex < groupSize)
             {
-              sProperty &prop = group.props[propIndex];
-              if (!command.args[j].GetString(prop.value))
-                prop.value.clear();
-              prop.initialized = true;
+              if (m_Columns)
+              {
+                unsigned int slot = static_cast<unsigned int>(pathData.groupSlot);
+                bool wasSet = m_Columns->IsSet(m_Row, slot, static_cast<unsigned int>(propIndex));
+                if (m_Columns->SetValue(m_Row, slot, static_cast<unsigned int>(propIndex), command.args[j]) && !wasSet)
+                  m_NumPendingProps--;
+              }
+              else
+              {
+                sProperty &prop = group.props[propIndex];
+                if (!command.args[j].GetString(prop.value))
+                  prop.value.clear();
+                if (!prop.initialized)
+                {
+                  prop.initialized = true;
+                  m_NumPendingProps--;
+                }
+              }
             }
             else
             {
@@ -181,7 +273,7 @@ void EosTarget::Recv(EosLog &log, EosOsc::sCommand &command, const sPathData &pa
               sprintf(buf, "%d", static_cast<int>(propIndex));
               text.append(buf);
               text.append(" of ");
-              sprintf(buf, "%d", static_cast<int>(group.props.size()));
+              sprintf(buf, "%d", static_cast<int>(groupSize));
               text.append(buf);
               log.AddError(text);
             }
@@ -189,23 +281,7 @@ void EosTarget::Recv(EosLog &log, EosOsc::sCommand &command, const sPathData &pa
         }
 
         // did we get all the properties we are expecting?
-        bool gotAllProps = true;
-        for (PROP_GROUPS::const_iterator j = m_PropGroups.begin(); j != m_PropGroups.end() && gotAllProps; j++)
-        {
-          const sPropertyGroup &g = j->second;
-          if (g.initialized)
-          {
-            for (PROPS::const_iterator k = g.props.begin(); k != g.props.end() && gotAllProps; k++)
-            {
-              if (!k->initialized)
-                gotAllProps = false;
-            }
-          }
-          else
-            gotAllProps = false;
-        }
-
-        if (gotAllProps)
+        if (m_NumPendingGroups == 0 && m_NumPendingProps == 0)
           m_Status.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);  // yup!
       }
       else
@@ -220,10 +296,13 @@ void EosTarget::Recv(EosLog &log, EosOsc::sCommand &command, const sPathData &pa
 
     default:
     {
-      std::string text("ignored unsolicited reply \"");
-      text.append(command.path);
-      text.append("\"");
-      log.AddInfo(text);
+      if (log.IsEnabled(EosLog::LOG_MSG_TYPE_INFO))
+      {
+        std::string text("ignored unsolicited reply \"");
+        text.append(command.path);
+        text.append("\"");
+        log.AddInfo(text);
+      }
     }
     break;
   }
@@ -238,6 +317,137 @@ void EosTarget::ClearDirty()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+size_t EosTarget::GetNumPendingProps(unsigned int slot) const
+{
+  size_t count = 0;
+
+  const sPropertyGroup &group = m_PropGroups[slot];
+  if (m_Columns)
+  {
+    for (size_t i = 0; i < group.columnCount; i++)
+    {
+      if (!m_Columns->IsSet(m_Row, slot, static_cast<unsigned int>(i)))
+        count++;
+    }
+  }
+  else
+  {
+    for (PROPS::const_iterator i = group.props.begin(); i != group.props.end(); i++)
+    {
+      if (!i->initialized)
+        count++;
+    }
+  }
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosTarget::sPropertyGroup *EosTarget::GetPropGroup(unsigned int slot) const
+{
+  return ((slot < GetNumPropGroups()) ? (&m_PropGroups[slot]) : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosTarget::sPropertyGroup *EosTarget::GetPropGroup(const char *name) const
+{
+  int slot = (name ? GetPropGroupSlot(m_Type, name, strlen(name)) : PROP_GROUP_INVALID);
+  return ((slot == PROP_GROUP_INVALID) ? 0 : (&m_PropGroups[slot]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosTarget::GetNumProps(unsigned int slot) const
+{
+  if (slot < GetNumPropGroups())
+  {
+    const sPropertyGroup &group = m_PropGroups[slot];
+    return (m_Columns ? group.columnCount : group.props.size());
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosTarget::sProperty *EosTarget::GetProp(unsigned int slot, unsigned int index) const
+{
+  if (slot < GetNumPropGroups())
+  {
+    const PROPS &props = m_PropGroups[slot].props;
+    if (index < props.size() && props[index].initialized)
+      return &props[index];
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTarget::GetPropInt(unsigned int slot, unsigned int index, int &n) const
+{
+  if (m_Columns)
+    return m_Columns->GetInt(m_Row, slot, index, n);
+
+  const sProperty *prop = GetProp(slot, index);
+  return (prop && EosPropertyColumns::GetIntFromString(prop->value.c_str(), n));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTarget::GetPropDecimal(unsigned int slot, unsigned int index, int64_t &n) const
+{
+  if (m_Columns)
+    return m_Columns->GetDecimal(m_Row, slot, index, n);
+
+  const sProperty *prop = GetProp(slot, index);
+  return (prop && EosPropertyColumns::GetDecimalFromString(prop->value.c_str(), n));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTarget::GetPropDouble(unsigned int slot, unsigned int index, double &d) const
+{
+  if (m_Columns)
+    return m_Columns->GetDouble(m_Row, slot, index, d);
+
+  const sProperty *prop = GetProp(slot, index);
+  return (prop && EosPropertyColumns::GetDoubleFromString(prop->value.c_str(), d));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTarget::GetPropString(unsigned int slot, unsigned int index, std::string &str) const
+{
+  if (m_Columns)
+    return m_Columns->GetString(m_Row, slot, index, str);
+
+  const sProperty *prop = GetProp(slot, index);
+  if (prop)
+  {
+    str = prop->value;
+    return true;
+  }
+
+  str.clear();
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *EosTarget::GetPropString(unsigned int slot, unsigned int index) const
+{
+  if (m_Columns)
+    return m_Columns->GetString(m_Row, slot, index);  // string arguments only
+
+  const sProperty *prop = GetProp(slot, index);
+  return (prop ? prop->value.c_str() : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 const char *EosTarget::GetNameForTargetType(EnumEosTargetType type)
 {
   switch (type)
@@ -265,77 +475,126 @@ const char *EosTarget::GetNameForTargetType(EnumEosTargetType type)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTarget::InitializePropGroupsForTargetType(EnumEosTargetType type, PROP_GROUPS &propGroups)
+EosTarget::EnumEosTargetType EosTarget::GetTargetTypeForName(const char *name, size_t len)
 {
-  propGroups.clear();
-  std::string general;
-  sPropertyGroup emptyGroup;
+  // open addressing table over the type names, hashed on first char, last char and length
+  // the current names all land in distinct slots, so a lookup is a single compare
+  struct sTypeTable
+  {
+    sTypeTable()
+    {
+      for (unsigned int i = 0; i < TABLE_SIZE; i++)
+        slots[i] = EOS_TARGET_INVALID;
 
-  switch (type)
+      for (int i = 0; i < EOS_TARGET_COUNT; i++)
+      {
+        EnumEosTargetType type = static_cast<EnumEosTargetType>(i);
+        const char *typeName = GetNameForTargetType(type);
+        size_t typeLen = strlen(typeName);
+        if (typeLen != 0)
+        {
+          unsigned int slot = Hash(typeName, typeLen);
+          while (slots[slot] != EOS_TARGET_INVALID)
+            slot = ((slot + 1) & (TABLE_SIZE - 1));
+          slots[slot] = type;
+        }
+      }
+    }
+
+    static unsigned int Hash(const char *name, size_t len)
+    {
+      unsigned int hash = (static_cast<unsigned char>(name[0]) + static_cast<unsigned char>(name[len - 1]) + static_cast<unsigned int>(len * 5));
+      return (hash & (TABLE_SIZE - 1));
+    }
+
+    enum EnumConstants
+    {
+      TABLE_SIZE = 64  // power of two
+    };
+
+    EnumEosTargetType slots[TABLE_SIZE];
+  };
+
+  static const sTypeTable sTable;
+
+  if (name && len != 0)
   {
-    case EOS_TARGET_PATCH:
-      propGroups[general] = emptyGroup;
-      propGroups["notes"] = emptyGroup;
-      break;
+    for (unsigned int slot = sTypeTable::Hash(name, len); sTable.slots[slot] != EOS_TARGET_INVALID; slot = ((slot + 1) & (sTypeTable::TABLE_SIZE - 1)))
+    {
+      EnumEosTargetType type = sTable.slots[slot];
+      const char *typeName = GetNameForTargetType(type);
+      if (strncmp(typeName, name, len) == 0 && typeName[len] == 0)
+        return type;
+    }
+  }
 
-    case EOS_TARGET_CUELIST:
-      propGroups[general] = emptyGroup;
-      propGroups["links"] = emptyGroup;
-      break;
+  return EOS_TARGET_INVALID;
+}
 
-    case EOS_TARGET_CUE:
-      propGroups[general] = emptyGroup;
-      propGroups["fx"] = emptyGroup;
-      propGroups["links"] = emptyGroup;
-      propGroups["actions"] = emptyGroup;
-      break;
+////////////////////////////////////////////////////////////////////////////////
 
-    case EOS_TARGET_GROUP:
-      propGroups[general] = emptyGroup;
-      propGroups["channels"] = emptyGroup;
-      break;
+uint64_t EosTarget::NewGeneration()
+{
+  // shared by every target and list of every EosSyncLib instance, never reused
+  static std::atomic<uint64_t> sGeneration(0);
+  return ++sGeneration;
+}
 
-    case EOS_TARGET_MACRO:
-      propGroups[general] = emptyGroup;
-      propGroups["text"] = emptyGroup;
-      break;
+////////////////////////////////////////////////////////////////////////////////
 
-    case EOS_TARGET_SUB:
-      propGroups[general] = emptyGroup;
-      propGroups["fx"] = emptyGroup;
-      break;
+const EosTarget::sPropGroupSchema &EosTarget::GetPropGroupSchema(EnumEosTargetType type)
+{
+  // indexed by EnumEosTargetType, constant-initialized so nothing is built at runtime
+  static const sPropGroupSchema sSchemas[EOS_TARGET_COUNT] = {
+    {2, {"", "notes"}},                         // EOS_TARGET_PATCH
+    {2, {"", "links"}},                         // EOS_TARGET_CUELIST
+    {4, {"", "fx", "links", "actions"}},        // EOS_TARGET_CUE
+    {2, {"", "channels"}},                      // EOS_TARGET_GROUP
+    {2, {"", "text"}},                          // EOS_TARGET_MACRO
+    {2, {"", "fx"}},                            // EOS_TARGET_SUB
+    {4, {"", "channels", "byType", "fx"}},      // EOS_TARGET_PRESET
+    {3, {"", "channels", "byType"}},            // EOS_TARGET_IP
+    {3, {"", "channels", "byType"}},            // EOS_TARGET_FP
+    {3, {"", "channels", "byType"}},            // EOS_TARGET_CP
+    {3, {"", "channels", "byType"}},            // EOS_TARGET_BP
+    {1, {""}},                                  // EOS_TARGET_CURVE
+    {1, {""}},                                  // EOS_TARGET_FX
+    {1, {""}},                                  // EOS_TARGET_SNAP
+    {2, {"", "channels"}},                      // EOS_TARGET_PIXMAP
+    {1, {""}}                                   // EOS_TARGET_MS
+  };
 
-    case EOS_TARGET_PRESET:
-      propGroups[general] = emptyGroup;
-      propGroups["channels"] = emptyGroup;
-      propGroups["byType"] = emptyGroup;
-      propGroups["fx"] = emptyGroup;
-      break;
+  static const sPropGroupSchema sEmptySchema = {0, {0}};
 
-    case EOS_TARGET_IP:
-    case EOS_TARGET_FP:
-    case EOS_TARGET_CP:
-    case EOS_TARGET_BP:
-      propGroups[general] = emptyGroup;
-      propGroups["channels"] = emptyGroup;
-      propGroups["byType"] = emptyGroup;
-      break;
+  return ((type >= 0 && type < EOS_TARGET_COUNT) ? sSchemas[type] : sEmptySchema);
+}
 
-    case EOS_TARGET_CURVE:
-    case EOS_TARGET_FX:
-    case EOS_TARGET_SNAP:
-    case EOS_TARGET_MS: propGroups[general] = emptyGroup; break;
+////////////////////////////////////////////////////////////////////////////////
 
-    case EOS_TARGET_PIXMAP:
-      propGroups[general] = emptyGroup;
-      propGroups["channels"] = emptyGroup;
-      break;
+const char *EosTarget::GetPropGroupNameForTargetType(EnumEosTargetType type, unsigned int slot)
+{
+  const sPropGroupSchema &schema = GetPropGroupSchema(type);
+  return ((slot < schema.count) ? schema.names[slot] : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int EosTarget::GetPropGroupSlot(EnumEosTargetType type, const char *name, size_t len)
+{
+  const sPropGroupSchema &schema = GetPropGroupSchema(type);
+  for (unsigned int i = 0; i < schema.count; i++)
+  {
+    const char *s = schema.names[i];
+    if (strncmp(s, name, len) == 0 && s[len] == 0)
+      return static_cast<int>(i);
   }
+
+  return PROP_GROUP_INVALID;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathData &pathData)
+bool EosTarget::ExtractPathData(EnumEosTargetType type, const std::string &path, size_t offset, sPathData &pathData)
 {
   // expecting the following variants:
   //
@@ -355,39 +614,33 @@ bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathDat
   // <id>/<group>/list/<index>/<total>
   // <id>/<part>/<group>/list/<index>/<total>
 
-  std::string part;
+  const char *s = path.c_str();
+  size_t size = path.size();
   bool gotId = false;
   bool gotPart = false;
   bool gotList = false;
   bool gotListIndex = false;
-  for (size_t i = offset; i < path.size();)
+  for (size_t i = offset; i < size;)
   {
     // get next part
-    part.clear();
-    size_t n = path.find("/", i);
-    if (n != std::string::npos)
-    {
-      size_t len = (n - i);
-      if (len != 0)
-        part = path.substr(i, n - i);
-    }
-    else
-      part = path.substr(i, path.size() - i);
+    const char *part = &s[i];
+    const char *separator = static_cast<const char *>(memchr(part, OSC_ADDR_SEPARATOR, size - i));
+    size_t len = (separator ? static_cast<size_t>(separator - part) : (size - i));
 
-    if (!part.empty())
+    if (len != 0)
     {
       // is it a number?
-      sDecimalNumber num;
-      if (GetNumberFromString(part, num))
+      sTargetNumber num;
+      if (GetNumberFromString(part, len, num))
       {
         if (gotList)
         {
           if (gotListIndex)
           {
             // list total
-            if (num.whole >= 0 && num.decimal == 0)
+            if (num.value >= 0 && num.IsWhole())
             {
-              pathData.listSize = static_cast<unsigned int>(num.whole);
+              pathData.listSize = static_cast<unsigned int>(num.GetWhole());
               return true;  // done
             }
             else
@@ -399,9 +652,9 @@ bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathDat
           else
           {
             // list index
-            if (num.whole >= 0 && num.decimal == 0)
+            if (num.value >= 0 && num.IsWhole())
             {
-              pathData.listIndex = static_cast<unsigned int>(num.whole);
+              pathData.listIndex = static_cast<unsigned int>(num.GetWhole());
               gotListIndex = true;
             }
             else
@@ -418,9 +671,9 @@ bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathDat
             // unhandled number
             return false;
           }
-          else if (num.decimal == 0)
+          else if (num.IsWhole())
           {
-            pathData.key.part = num.whole;
+            pathData.key.part = num.GetWhole();
             gotPart = true;
           }
           else
@@ -439,7 +692,7 @@ bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathDat
       else if (gotId)
       {
         // must be list for group
-        if (part == "list")
+        if (len == 4 && memcmp(part, "list", 4) == 0)
         {
           if (gotList)
           {
@@ -450,7 +703,7 @@ bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathDat
             gotList = true;
         }
         else
-          pathData.group = part;
+          pathData.groupSlot = GetPropGroupSlot(type, part, len);
       }
       else
       {
@@ -459,7 +712,7 @@ bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathDat
       }
     }
 
-    i += (part.size() + 1);
+    i += (len + 1);
   }
 
   // must have at least an id, and a list would have returned true once it got the list size above
@@ -468,654 +721,2214 @@ bool EosTarget::ExtractPathData(const std::string &path, size_t offset, sPathDat
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool EosTarget::GetNumberFromString(const std::string &str, sDecimalNumber &num)
+bool EosTarget::GetNumberFromString(const char *str, size_t len, sTargetNumber &num)
 {
-  // get id portion
-  if (!str.empty())
-  {
-    size_t n = str.find(".");
-    if (n == std::string::npos)
-    {
-      // whole number
-      const char *s = str.c_str();
-      if (OSCArgument::IsIntString(s))
-      {
-        num.whole = atoi(s);
-        num.decimal = 0;
-        return true;
-      }
-    }
-    else
-    {
-      // decimal number
-      bool decimalNegative = false;
-      if (n != 0)
-      {
-        std::string wholeStr(str, 0, n);
-        const char *s = wholeStr.c_str();
-        if (wholeStr == "-")
-        {
-          num.whole = 0;
-          decimalNegative = true;
-        }
-        else if (OSCArgument::IsIntString(s))
-        {
-          num.whole = atoi(s);
-          if (num.whole == 0 && s && (*s) == '-')
-            decimalNegative = true;
-        }
-        else
-          return false;
-      }
-      else
-        num.whole = 0;
-
-      if (++n < str.size())
-      {
-        std::string decimalStr(str.substr(n, str.size() - n));
-        const char *s = decimalStr.c_str();
-
-        if (s)
-        {
-          num.decimal = 0;
-
-          int exp = TARGET_DECIMALS;
-          for (const char *p = s; *p; p++)
-          {
-            if (--exp < 0)
-              break;
+  // [+|-][<whole>][.<decimal>], decimal digits past NUMBER_DECIMALS are ignored
+  if (!str)
+    return false;
 
-            int digit = (*p - '0');
-            if (digit < 0 || digit > 9)
-              return false;  // non-digit
+  const char *p = str;
+  const char *end = (str + len);
 
-            num.decimal += (digit * static_cast<int>(pow(10.0, exp)));
-          }
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = (*p++ == '-');
 
-          if (num.decimal > 0 && decimalNegative)
-            num.decimal *= -1;
+  bool gotDigit = false;
+  int64_t whole = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; p++)
+  {
+    whole = ((whole * 10) + (*p - '0'));
+    if (whole > INT_MAX)
+      return false;
+    gotDigit = true;
+  }
 
-          return true;
-        }
+  int64_t decimal = 0;
+  if (p < end && *p == '.')
+  {
+    int digits = 0;
+    for (p++; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+      if (digits < NUMBER_DECIMALS)
+      {
+        decimal = ((decimal * 10) + (*p - '0'));
+        digits++;
       }
-      else
-        num.decimal = 0;
-
-      return true;
+      gotDigit = true;
     }
+
+    for (; digits < NUMBER_DECIMALS; digits++)
+      decimal *= 10;
   }
 
-  return false;
+  if (p != end || !gotDigit)
+    return false;
+
+  num.value = ((whole * NUMBER_SCALE) + decimal);
+  if (negative)
+    num.value = -num.value;
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTarget::GetStringFromNumber(const sDecimalNumber &num, std::string &str)
+size_t EosTarget::GetStringFromNumber(const sTargetNumber &num, char *buf, size_t size)
 {
-  str.clear();
+  // written back to front, no trailing decimal zeroes
+  char str[MAX_NUMBER_STRING_SIZE];
+  char *p = &str[sizeof(str)];
 
-  if (num.whole == 0 && num.decimal < 0)
-    str = "-";
+  uint64_t n = ((num.value < 0) ? (0 - static_cast<uint64_t>(num.value)) : static_cast<uint64_t>(num.value));
+  uint64_t whole = (n / NUMBER_SCALE);
+  unsigned int decimal = static_cast<unsigned int>(n % NUMBER_SCALE);
 
-  char buf[64];
-  sprintf(buf, "%d", num.whole);
-  str.append(buf);
-
-  if (num.decimal != 0)
+  if (decimal != 0)
   {
-    int n = abs(num.decimal);
-    if (n < pow(10.0, TARGET_DECIMALS))
+    int digits = NUMBER_DECIMALS;
+    for (; (decimal % 10) == 0; digits--)
+      decimal /= 10;
+
+    for (; digits > 0; digits--)
     {
-      char fmt[64];
-      strcpy(fmt, "%.");
-      sprintf(&fmt[2], "%d", TARGET_DECIMALS);
-      strcat(fmt, "d");
-      sprintf(buf, fmt, n);
-      // chop trailing zeroes
-      for (int i = (static_cast<int>(strlen(buf)) - 1); i >= 0; i--)
-      {
-        if (buf[i] == '0')
-          buf[i] = 0;
-        else
-          break;
-      }
-      if (*buf)
-      {
-        str.append(".");
-        str.append(buf);
-      }
+      *(--p) = static_cast<char>('0' + (decimal % 10));
+      decimal /= 10;
     }
+    *(--p) = '.';
   }
-}
 
-////////////////////////////////////////////////////////////////////////////////
+  do
+  {
+    *(--p) = static_cast<char>('0' + (whole % 10));
+    whole /= 10;
+  } while (whole != 0 && p != str);
 
-const EosTargetList EosTargetList::sm_InvalidTargetList(EosTarget::EOS_TARGET_INVALID, 0);
+  if (num.value < 0 && p != str)
+    *(--p) = '-';
 
-////////////////////////////////////////////////////////////////////////////////
+  size_t len = static_cast<size_t>(&str[sizeof(str)] - p);
+  if (!buf || len >= size)
+    return 0;
 
-EosTargetList::EosTargetList(EosTarget::EnumEosTargetType type, int listId)
-  : m_Type(type)
-  , m_ListId(listId)
-  , m_NumTargets(0)
-{
+  memcpy(buf, p, len);
+  buf[len] = 0;
+  return len;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosTargetList::~EosTargetList()
+void EosTarget::GetStringFromNumber(const sTargetNumber &num, std::string &str)
 {
-  Clear();
+  char buf[MAX_NUMBER_STRING_SIZE];
+  size_t len = GetStringFromNumber(num, buf, sizeof(buf));
+  str.assign(buf, len);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTargetList::Clear()
+bool EosTarget::GetNumberFromString(const std::string &str, sDecimalNumber &num)
 {
-  for (TARGETS::const_iterator i = m_Targets.begin(); i != m_Targets.end(); i++)
+  sTargetNumber n;
+  if (GetNumberFromString(str.c_str(), str.size(), n))
   {
-    const PARTS &parts = i->second.list;
-    for (PARTS::const_iterator j = parts.begin(); j != parts.end(); j++)
-      delete j->second;
+    num = n.GetDecimalNumber();
+    return true;
   }
-  m_Targets.clear();
-  m_NumTargets = 0;
-  m_UIDLookup.clear();
-  m_InitialSync = sInitialSyncInfo();
-  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_UNINTIALIZED);
-  m_StatusInternal.SetValue(EosSyncStatus::SYNC_STATUS_UNINTIALIZED);
+
+  return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTargetList::Tick(EosTcp &tcp, EosOsc &osc)
+void EosTarget::GetStringFromNumber(const sDecimalNumber &num, std::string &str)
 {
-  switch (m_StatusInternal.GetValue())
-  {
-    case EosSyncStatus::SYNC_STATUS_UNINTIALIZED:
+  GetStringFromNumber(sTargetNumber(num), str);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTarget::GetUIDFromString(const char *str, size_t len, sUID &uid)
+{
+  uid = sUID();
+  if (!str || len == 0)
+    return false;
+
+  // GUID text, 32 hex digits with optional dashes and braces
+  unsigned int digits = 0;
+  for (size_t i = 0; i < len; i++)
+  {
+    char c = str[i];
+    unsigned int n;
+    if (c >= '0' && c <= '9')
+      n = static_cast<unsigned int>(c - '0');
+    else if (c >= 'A' && c <= 'F')
+      n = static_cast<unsigned int>(c - 'A' + 10);
+    else if (c >= 'a' && c <= 'f')
+      n = static_cast<unsigned int>(c - 'a' + 10);
+    else if (c == '-' || c == '{' || c == '}')
+      continue;
+    else
+    {
+      digits = 0;
+      break;
+    }
+
+    if (digits < 16)
+      uid.hi = ((uid.hi << 4) | n);
+    else if (digits < 32)
+      uid.lo = ((uid.lo << 4) | n);
+    if (++digits > 32)
+      break;
+  }
+
+  if (digits != 32 || !uid.valid())
+  {
+    // not a GUID, key on two FNV-1a hashes of the text instead
+    uint64_t h1 = 14695981039346656037ull;
+    uint64_t h2 = 0x84222325cbf29ce4ull;
+    for (size_t i = 0; i < len; i++)
+    {
+      uint8_t c = static_cast<uint8_t>(str[i]);
+      h1 = ((h1 ^ c) * 1099511628211ull);
+      h2 = ((h2 ^ c) * 0x100000001b3ull) + 0x9e3779b97f4a7c15ull;
+    }
+    uid.hi = h1;
+    uid.lo = (h2 ? h2 : 1);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTarget::GetStringFromUID(const sUID &uid, std::string &str)
+{
+  static const char sHex[] = "0123456789ABCDEF";
+
+  str.clear();
+  str.reserve(36);
+  for (unsigned int i = 0; i < 32; i++)
+  {
+    if (i == 8 || i == 12 || i == 16 || i == 20)
+      str.push_back('-');
+    uint64_t n = ((i < 16) ? uid.hi : uid.lo);
+    str.push_back(sHex[(n >> (60 - ((i % 16) * 4))) & 0xf]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosChangeJournal::EosChangeJournal(size_t capacity)
+  : m_Capacity(capacity)
+  , m_Size(0)
+  , m_Version(0)
+  , m_Batching(false)
+{
+  m_Changes.resize(m_Capacity);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChangeJournal::Clear()
+{
+  // version keeps counting, so existing cursors see they missed changes
+  m_Size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChangeJournal::SetCapacity(size_t capacity)
+{
+  if (m_Capacity == capacity)
+    return;
+
+  // keep the newest changes that still fit
+  CHANGES changes(capacity);
+  size_t size = ((m_Size < capacity) ? m_Size : capacity);
+  for (uint64_t v = (m_Version + 1 - size); v <= m_Version; v++)
+    changes[v % capacity] = m_Changes[v % m_Capacity];
+
+  m_Changes.swap(changes);
+  m_Capacity = capacity;
+  m_Size = size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t EosChangeJournal::Add(EnumChangeKind kind, EosTarget::EnumEosTargetType type, int listId, const EosTarget::sTargetNumber &num, int part, int groupSlot)
+{
+  sChange change;
+  change.version = ++m_Version;
+  change.kind = kind;
+  change.type = type;
+  change.listId = listId;
+  change.num = num;
+  change.part = part;
+  change.groupSlot = groupSlot;
+
+  if (m_Capacity != 0)
+  {
+    m_Changes[m_Version % m_Capacity] = change;
+    if (m_Size < m_Capacity)
+      m_Size++;
+  }
+
+  if (m_Batching)
+    m_Batch.push_back(change);
+
+  return m_Version;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChangeJournal::SetBatching(bool batching)
+{
+  m_Batching = batching;
+  if (!m_Batching)
+    m_Batch.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChangeJournal::TakeBatch(CHANGES &changes)
+{
+  changes.clear();
+  changes.swap(m_Batch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChangeJournal::Read(uint64_t &cursor, CHANGES &changes, size_t maxChanges) const
+{
+  if (cursor > m_Version || (cursor + 1) < GetOldestVersion())
+  {
+    // changes were dropped, caller must rescan
+    cursor = m_Version;
+    return false;
+  }
+
+  uint64_t last = m_Version;
+  if (maxChanges != 0 && (last - cursor) > maxChanges)
+    last = (cursor + maxChanges);
+
+  for (uint64_t v = (cursor + 1); v <= last; v++)
+    changes.push_back(m_Changes[v % m_Capacity]);
+
+  cursor = last;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosChannelIndex::sRef::operator<(const sRef &other) const
+{
+  if (type != other.type)
+    return (type < other.type);
+  if (listId != other.listId)
+    return (listId < other.listId);
+  return (key < other.key);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::Clear()
+{
+  m_Entries.clear();
+  m_FreeEntries.clear();
+  m_Lookup.clear();
+  m_Blocks.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::Set(const sRef &ref, const EosChannelSet &channels)
+{
+  LOOKUP::iterator i = m_Lookup.find(ref);
+  if (i != m_Lookup.end())
+  {
+    if (m_Entries[i->second].channels == channels)
+      return;
+
+    if (channels.IsEmpty())
+    {
+      RemoveEntry(i);
+      return;
+    }
+
+    RemoveFromBlocks(i->second);
+    m_Entries[i->second].channels = channels;
+    AddToBlocks(i->second);
+  }
+  else if (!channels.IsEmpty())
+  {
+    uint32_t entry;
+    if (m_FreeEntries.empty())
+    {
+      entry = static_cast<uint32_t>(m_Entries.size());
+      m_Entries.push_back(sEntry());
+    }
+    else
+    {
+      entry = m_FreeEntries.back();
+      m_FreeEntries.pop_back();
+    }
+
+    m_Entries[entry].ref = ref;
+    m_Entries[entry].channels = channels;
+    m_Lookup[ref] = entry;
+    AddToBlocks(entry);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::Remove(const sRef &ref)
+{
+  LOOKUP::iterator i = m_Lookup.find(ref);
+  if (i != m_Lookup.end())
+    RemoveEntry(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::RemoveList(EosTarget::EnumEosTargetType type, int listId)
+{
+  LOOKUP::iterator i = m_Lookup.lower_bound(GetFirstRef(type, listId));
+  while (i != m_Lookup.end() && i->first.type == type && i->first.listId == listId)
+    RemoveEntry(i++);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::GetListChannels(EosTarget::EnumEosTargetType type, int listId, EosChannelBitmap &channels) const
+{
+  for (LOOKUP::const_iterator i = m_Lookup.lower_bound(GetFirstRef(type, listId)); i != m_Lookup.end() && i->first.type == type && i->first.listId == listId; i++)
+    channels.Add(m_Entries[i->second].channels);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosChannelIndex::sRef EosChannelIndex::GetFirstRef(EosTarget::EnumEosTargetType type, int listId)
+{
+  sRef ref;
+  ref.type = type;
+  ref.listId = listId;
+  ref.key = EosTarget::sTargetKey(EosTarget::sTargetNumber::FromValue(INT64_MIN), INT_MIN);
+  return ref;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosChannelSet *EosChannelIndex::GetChannels(const sRef &ref) const
+{
+  LOOKUP::const_iterator i = m_Lookup.find(ref);
+  return ((i == m_Lookup.end()) ? 0 : (&m_Entries[i->second].channels));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::GetTargets(uint32_t channel, REFS &refs) const
+{
+  size_t block = (channel >> BLOCK_BITS);
+  if (block >= m_Blocks.size())
+    return;
+
+  size_t start = refs.size();
+  const ENTRY_LIST &entries = m_Blocks[block];
+  for (ENTRY_LIST::const_iterator i = entries.begin(); i != entries.end(); i++)
+  {
+    const sEntry &entry = m_Entries[*i];
+    if (entry.channels.Contains(channel))
+      refs.push_back(entry.ref);
+  }
+
+  std::sort(refs.begin() + start, refs.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::GetChannelsFromTarget(const EosTarget &target, unsigned int slot, EosChannelSet &channels)
+{
+  channels.Clear();
+
+  // first two properties are the target number and UID
+  size_t numProps = target.GetNumProps(slot);
+  std::string str;
+  for (size_t i = 2; i < numProps; i++)
+  {
+    const char *s = target.GetPropString(slot, static_cast<unsigned int>(i));
+    if (!s)
+    {
+      // int argument in column storage
+      if (!target.GetPropString(slot, static_cast<unsigned int>(i), str))
+        continue;
+      s = str.c_str();
+    }
+
+    uint32_t first = 0;
+    uint32_t last = 0;
+    if (EosChannelSet::ParseRange(s, first, last))
+      channels.AddRange(first, last);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::AddToBlocks(uint32_t entry)
+{
+  const EosChannelSet::RUNS &runs = m_Entries[entry].channels.GetRuns();
+  size_t prevBlock = static_cast<size_t>(-1);
+  for (EosChannelSet::RUNS::const_iterator i = runs.begin(); i != runs.end(); i++)
+  {
+    // bound the block table by the console's channel range
+    if (i->first > EosChannelSet::MAX_CHANNEL)
+      break;
+
+    uint32_t last = ((i->last > EosChannelSet::MAX_CHANNEL) ? static_cast<uint32_t>(EosChannelSet::MAX_CHANNEL) : i->last);
+    size_t lastBlock = (last >> BLOCK_BITS);
+    if (lastBlock >= m_Blocks.size())
+      m_Blocks.resize(lastBlock + 1);
+
+    for (size_t block = (i->first >> BLOCK_BITS); block <= lastBlock; block++)
+    {
+      // runs are sorted, so a block shared by two runs is always the previous one
+      if (block != prevBlock)
+      {
+        m_Blocks[block].push_back(entry);
+        prevBlock = block;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::RemoveFromBlocks(uint32_t entry)
+{
+  const EosChannelSet::RUNS &runs = m_Entries[entry].channels.GetRuns();
+  size_t prevBlock = static_cast<size_t>(-1);
+  for (EosChannelSet::RUNS::const_iterator i = runs.begin(); i != runs.end(); i++)
+  {
+    size_t lastBlock = (i->last >> BLOCK_BITS);
+    for (size_t block = (i->first >> BLOCK_BITS); block <= lastBlock && block < m_Blocks.size(); block++)
+    {
+      if (block == prevBlock)
+        continue;
+
+      prevBlock = block;
+      ENTRY_LIST &entries = m_Blocks[block];
+      for (size_t j = 0; j < entries.size(); j++)
+      {
+        if (entries[j] == entry)
+        {
+          entries[j] = entries.back();
+          entries.pop_back();
+          break;
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosChannelIndex::RemoveEntry(LOOKUP::iterator i)
+{
+  uint32_t entry = i->second;
+  RemoveFromBlocks(entry);
+  m_Entries[entry].channels.Clear();
+  m_FreeEntries.push_back(entry);
+  m_Lookup.erase(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosPatchIndex::EosPatchIndex()
+  : m_MaxFootprint(1)
+  , m_DefaultFootprint(DEFAULT_FOOTPRINT)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::Clear()
+{
+  m_Lookup.clear();
+  m_ByAddress.clear();
+  m_MaxFootprint = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::Set(const EosTarget::sTargetKey &key, uint32_t address, uint32_t footprint)
+{
+  if (footprint == 0)
+    footprint = 1;
+
+  LOOKUP::iterator i = m_Lookup.find(key);
+  if (i != m_Lookup.end())
+  {
+    if (i->second.address == address && i->second.footprint == footprint)
+      return;
+
+    Remove(key);
+  }
+
+  if (address == 0)
+    return;  // unpatched
+
+  sPatch patch;
+  patch.key = key;
+  patch.address = address;
+  patch.footprint = footprint;
+  m_Lookup[key] = patch;
+  m_ByAddress.insert(BY_ADDRESS::value_type(address, key));
+
+  if (footprint > m_MaxFootprint)
+    m_MaxFootprint = footprint;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::Remove(const EosTarget::sTargetKey &key)
+{
+  LOOKUP::iterator i = m_Lookup.find(key);
+  if (i == m_Lookup.end())
+    return;
+
+  std::pair<BY_ADDRESS::iterator, BY_ADDRESS::iterator> range = m_ByAddress.equal_range(i->second.address);
+  for (BY_ADDRESS::iterator j = range.first; j != range.second; j++)
+  {
+    if (j->second == key)
+    {
+      m_ByAddress.erase(j);
+      break;
+    }
+  }
+
+  m_Lookup.erase(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::Update(const EosTarget::sTargetKey &key, const EosTarget &target)
+{
+  std::string str;
+  const char *addressStr = target.GetPropString(EosTarget::PROP_GROUP_GENERAL, PROP_INDEX_ADDRESS);
+  if (!addressStr)
+  {
+    // int argument in column storage
+    if (!target.GetPropString(EosTarget::PROP_GROUP_GENERAL, PROP_INDEX_ADDRESS, str))
+    {
+      Remove(key);
+      return;
+    }
+    addressStr = str.c_str();
+  }
+
+  uint32_t address = 0;
+  if (!ParseAddress(addressStr, address))
+    address = 0;
+
+  Set(key, address, GetFootprint(target.GetPropString(EosTarget::PROP_GROUP_GENERAL, PROP_INDEX_MODEL)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosPatchIndex::sPatch *EosPatchIndex::GetPatch(const EosTarget::sTargetKey &key) const
+{
+  LOOKUP::const_iterator i = m_Lookup.find(key);
+  return ((i == m_Lookup.end()) ? 0 : (&i->second));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::GetPatches(uint32_t address, PATCHES &patches) const
+{
+  GetOverlapping(address, 1, patches);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::GetPatches(unsigned int universe, unsigned int address, PATCHES &patches) const
+{
+  if (universe != 0 && address != 0 && address <= UNIVERSE_SIZE)
+    GetOverlapping(GetAbsoluteAddress(universe, address), 1, patches);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::GetOverlapping(uint32_t address, uint32_t count, PATCHES &patches) const
+{
+  if (count == 0)
+    return;
+
+  uint64_t last = (static_cast<uint64_t>(address) + count - 1);
+
+  // nothing starting further back than the largest footprint can reach address
+  uint32_t start = ((address > m_MaxFootprint) ? (address - m_MaxFootprint + 1) : 0);
+  for (BY_ADDRESS::const_iterator i = m_ByAddress.lower_bound(start); i != m_ByAddress.end() && i->first <= last; i++)
+  {
+    LOOKUP::const_iterator j = m_Lookup.find(i->second);
+    if (j != m_Lookup.end() && j->second.GetLastAddress() >= address)
+      patches.push_back(j->second);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::GetConflicts(CONFLICTS &conflicts) const
+{
+  // sweep in address order, comparing each part with the following parts it reaches
+  for (BY_ADDRESS::const_iterator i = m_ByAddress.begin(); i != m_ByAddress.end(); i++)
+  {
+    LOOKUP::const_iterator a = m_Lookup.find(i->second);
+    if (a == m_Lookup.end())
+      continue;
+
+    BY_ADDRESS::const_iterator j = i;
+    for (j++; j != m_ByAddress.end() && j->first <= a->second.GetLastAddress(); j++)
+    {
+      LOOKUP::const_iterator b = m_Lookup.find(j->second);
+      if (b != m_Lookup.end())
+        conflicts.push_back(std::make_pair(a->second, b->second));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosPatchIndex::SetModelFootprint(const std::string &model, uint32_t footprint)
+{
+  if (footprint == 0)
+    m_ModelFootprints.erase(model);
+  else
+    m_ModelFootprints[model] = footprint;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t EosPatchIndex::GetFootprint(const char *model) const
+{
+  if (model && !m_ModelFootprints.empty())
+  {
+    FOOTPRINTS::const_iterator i = m_ModelFootprints.find(model);
+    if (i != m_ModelFootprints.end())
+      return i->second;
+  }
+
+  return m_DefaultFootprint;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosPatchIndex::ParseAddress(const char *str, uint32_t &address)
+{
+  if (!str)
+    return false;
+
+  while (*str == ' ')
+    str++;
+
+  uint64_t n[2] = {0, 0};
+  unsigned int numCount = 0;
+  for (;;)
+  {
+    if (*str < '0' || *str > '9')
+      return false;
+
+    for (; *str >= '0' && *str <= '9'; str++)
+    {
+      n[numCount] = ((n[numCount] * 10) + static_cast<uint64_t>(*str - '0'));
+      if (n[numCount] > UINT32_MAX)
+        return false;
+    }
+    numCount++;
+
+    if (*str == '/' && numCount == 1)
+      str++;
+    else
+      break;
+  }
+
+  while (*str == ' ')
+    str++;
+
+  if (*str != 0)
+    return false;
+
+  if (numCount == 2)
+  {
+    // universe/address
+    if (n[0] == 0 || n[1] == 0 || n[1] > UNIVERSE_SIZE)
+      return false;
+    uint64_t absolute = (((n[0] - 1) * UNIVERSE_SIZE) + n[1]);
+    if (absolute > UINT32_MAX)
+      return false;
+    address = static_cast<uint32_t>(absolute);
+  }
+  else
+    address = static_cast<uint32_t>(n[0]);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosLabelIndex::EosLabelIndex()
+  : m_Enabled(false)
+  , m_NumPostings(0)
+  , m_NumStalePostings(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::SetEnabled(bool enabled)
+{
+  m_Enabled = enabled;
+  if (!m_Enabled)
+    Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::Clear()
+{
+  m_Entries.clear();
+  m_FreeEntries.clear();
+  m_Lookup.clear();
+  m_Postings.clear();
+  m_NumPostings = 0;
+  m_NumStalePostings = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::Set(const sRef &ref, const char *label)
+{
+  if (!m_Enabled)
+    return;
+
+  std::string folded;
+  FoldCase(label, folded);
+
+  LOOKUP::iterator i = m_Lookup.find(ref);
+  if (i != m_Lookup.end())
+  {
+    if (m_Entries[i->second].label == folded)
+      return;
+
+    if (folded.empty())
+    {
+      RemoveEntry(i);
+      return;
+    }
+
+    RemoveFromPostings(i->second);
+    m_Entries[i->second].label.swap(folded);
+    AddToPostings(i->second);
+  }
+  else if (!folded.empty())
+  {
+    uint32_t entry;
+    if (m_FreeEntries.empty())
+    {
+      entry = static_cast<uint32_t>(m_Entries.size());
+      m_Entries.push_back(sEntry());
+    }
+    else
+    {
+      entry = m_FreeEntries.back();
+      m_FreeEntries.pop_back();
+    }
+
+    m_Entries[entry].ref = ref;
+    m_Entries[entry].label.swap(folded);
+    m_Lookup[ref] = entry;
+    AddToPostings(entry);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::Remove(const sRef &ref)
+{
+  LOOKUP::iterator i = m_Lookup.find(ref);
+  if (i != m_Lookup.end())
+    RemoveEntry(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::RemoveList(EosTarget::EnumEosTargetType type, int listId)
+{
+  sRef first;
+  first.type = type;
+  first.listId = listId;
+  first.key = EosTarget::sTargetKey(EosTarget::sTargetNumber::FromValue(INT64_MIN), INT_MIN);
+
+  LOOKUP::iterator i = m_Lookup.lower_bound(first);
+  while (i != m_Lookup.end() && i->first.type == type && i->first.listId == listId)
+    RemoveEntry(i++);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::Update(const sRef &ref, const EosTarget &target)
+{
+  if (!m_Enabled)
+    return;
+
+  const char *label = target.GetPropString(EosTarget::PROP_GROUP_GENERAL, PROP_INDEX_LABEL);
+  Set(ref, label ? label : "");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const std::string *EosLabelIndex::GetLabel(const sRef &ref) const
+{
+  LOOKUP::const_iterator i = m_Lookup.find(ref);
+  return ((i == m_Lookup.end()) ? 0 : (&m_Entries[i->second].label));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::Search(const char *text, size_t limit, RESULTS &results, EosTarget::EnumEosTargetType type) const
+{
+  results.clear();
+  if (limit == 0)
+    return;
+
+  std::string folded;
+  FoldCase(text, folded);
+  if (folded.empty())
+    return;
+
+  // only the targets of the rarest gram can match
+  const POSTING_LIST *candidates = 0;
+  if (folded.size() < TRIGRAM_SIZE)
+  {
+    POSTINGS::const_iterator i = m_Postings.find(GetWordStartGram(folded.c_str(), folded.size()));
+    if (i != m_Postings.end())
+      candidates = &i->second;
+  }
+  else
+  {
+    for (size_t i = 0; (i + TRIGRAM_SIZE) <= folded.size(); i++)
+    {
+      POSTINGS::const_iterator j = m_Postings.find(GetTrigram(&folded[i]));
+      if (j == m_Postings.end())
+        return;
+      if (!candidates || j->second.size() < candidates->size())
+        candidates = &j->second;
+    }
+  }
+
+  if (!candidates)
+    return;
+
+  // keep the best limit results so far, worst is the last of them once there are enough
+  sResult worst;
+  worst.match = MATCH_INVALID;
+  worst.labelSize = 0;
+  for (POSTING_LIST::const_iterator i = candidates->begin(); i != candidates->end(); i++)
+  {
+    if (i->labelSize < folded.size())
+      continue;
+
+    if (worst.match != MATCH_INVALID)
+    {
+      // best case is a prefix match, or exact for the same size
+      EnumMatch best = ((i->labelSize == folded.size()) ? MATCH_EXACT : MATCH_PREFIX);
+      if (best > worst.match || (best == worst.match && i->labelSize > worst.labelSize))
+        continue;
+    }
+
+    if (!IsLive(*i))
+      continue;
+
+    const sEntry &entry = m_Entries[i->entry];
+    if (type != EosTarget::EOS_TARGET_INVALID && entry.ref.type != type)
+      continue;
+
+    EnumMatch match = GetMatch(entry.label, folded);
+    if (match == MATCH_INVALID)
+      continue;
+
+    sResult result;
+    result.ref = entry.ref;
+    result.match = match;
+    result.labelSize = i->labelSize;
+    results.push_back(result);
+
+    if (results.size() >= (limit * 2))
+    {
+      std::nth_element(results.begin(), results.begin() + (limit - 1), results.end(), IsBetterResult);
+      results.resize(limit);
+      worst = results.back();
+    }
+  }
+
+  if (results.size() > limit)
+  {
+    std::partial_sort(results.begin(), results.begin() + limit, results.end(), IsBetterResult);
+    results.resize(limit);
+  }
+  else
+    std::sort(results.begin(), results.end(), IsBetterResult);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::FoldCase(const char *str, std::string &folded)
+{
+  folded.clear();
+  if (!str)
+    return;
+
+  // ASCII only, UTF-8 sequences are copied as is
+  folded.assign(str);
+  for (std::string::iterator i = folded.begin(); i != folded.end(); i++)
+  {
+    if (*i >= 'A' && *i <= 'Z')
+      *i = static_cast<char>(*i - 'A' + 'a');
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosLabelIndex::EnumMatch EosLabelIndex::GetMatch(const std::string &label, const std::string &text)
+{
+  // std::string::find scans for the first byte with memchr, which the C library vectorizes
+  size_t pos = label.find(text);
+  if (pos == std::string::npos)
+    return MATCH_INVALID;
+
+  if (pos == 0)
+    return ((label.size() == text.size()) ? MATCH_EXACT : MATCH_PREFIX);
+
+  for (; pos != std::string::npos; pos = label.find(text, pos + 1))
+  {
+    if (!IsWordChar(label[pos - 1]))
+      return MATCH_WORD;
+  }
+
+  return MATCH_ANYWHERE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::AddToPostings(uint32_t entry)
+{
+  sPosting posting;
+  posting.entry = entry;
+  posting.stamp = m_Entries[entry].stamp;
+  posting.labelSize = static_cast<uint32_t>(m_Entries[entry].label.size());
+
+  GetGrams(m_Entries[entry].label, m_Grams);
+  for (GRAMS::const_iterator i = m_Grams.begin(); i != m_Grams.end(); i++)
+    m_Postings[*i].push_back(posting);
+  m_NumPostings += m_Grams.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::RemoveFromPostings(uint32_t entry)
+{
+  // postings of the old stamp are skipped from now on
+  GetGrams(m_Entries[entry].label, m_Grams);
+  m_NumStalePostings += m_Grams.size();
+  m_Entries[entry].stamp++;
+
+  if (m_NumStalePostings > (m_NumPostings / 2))
+    CompactPostings();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::RemoveEntry(LOOKUP::iterator i)
+{
+  uint32_t entry = i->second;
+  m_Lookup.erase(i);
+  RemoveFromPostings(entry);
+  m_Entries[entry].label.clear();
+  m_FreeEntries.push_back(entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::CompactPostings()
+{
+  if (m_Lookup.empty())
+  {
+    // everything is stale
+    m_Postings.clear();
+    m_NumPostings = 0;
+    m_NumStalePostings = 0;
+    return;
+  }
+
+  for (POSTINGS::iterator i = m_Postings.begin(); i != m_Postings.end();)
+  {
+    POSTING_LIST &postings = i->second;
+    size_t live = 0;
+    for (size_t j = 0; j < postings.size(); j++)
+    {
+      if (IsLive(postings[j]))
+        postings[live++] = postings[j];
+    }
+
+    if (live == 0)
+    {
+      i = m_Postings.erase(i);
+    }
+    else
+    {
+      postings.resize(live);
+      i++;
+    }
+  }
+
+  m_NumPostings -= m_NumStalePostings;
+  m_NumStalePostings = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosLabelIndex::GetGrams(const std::string &str, GRAMS &grams)
+{
+  grams.clear();
+
+  for (size_t i = 0; (i + TRIGRAM_SIZE) <= str.size(); i++)
+    grams.push_back(GetTrigram(&str[i]));
+
+  for (size_t i = 0; i < str.size(); i++)
+  {
+    if (i == 0 || !IsWordChar(str[i - 1]))
+    {
+      grams.push_back(GetWordStartGram(&str[i], 1));
+      if ((i + 1) < str.size())
+        grams.push_back(GetWordStartGram(&str[i], 2));
+    }
+  }
+
+  std::sort(grams.begin(), grams.end());
+  grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t EosLabelIndex::GetTrigram(const char *str)
+{
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(str);
+  return ((static_cast<uint32_t>(s[0]) << 16) | (static_cast<uint32_t>(s[1]) << 8) | static_cast<uint32_t>(s[2]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t EosLabelIndex::GetWordStartGram(const char *str, size_t size)
+{
+  // above the 24 bits of a trigram, tagged by size
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(str);
+  if (size == 1)
+    return ((1u << 24) | static_cast<uint32_t>(s[0]));
+  return ((2u << 24) | (static_cast<uint32_t>(s[0]) << 8) | static_cast<uint32_t>(s[1]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosLabelIndex::IsWordChar(char c)
+{
+  // bytes of UTF-8 sequences never start a word
+  unsigned char u = static_cast<unsigned char>(c);
+  return ((u >= 'a' && u <= 'z') || (u >= '0' && u <= '9') || u >= 0x80);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosLabelIndex::IsBetterResult(const sResult &a, const sResult &b)
+{
+  if (a.match != b.match)
+    return (a.match < b.match);
+  if (a.labelSize != b.labelSize)
+    return (a.labelSize < b.labelSize);
+  return (a.ref < b.ref);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosTargetList EosTargetList::sm_InvalidTargetList(EosTarget::EOS_TARGET_INVALID, 0);
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetList::EosTargetList(EosTarget::EnumEosTargetType type, int listId, EnumPropertyStorage storage, EosStringPool *stringPool, EosMemoryResource *memory,
+                             EosChangeJournal *journal, EosChannelIndex *channelIndex, EosPatchIndex *patchIndex, EosLabelIndex *labelIndex)
+  : m_Type(type)
+  , m_ListId(listId)
+  , m_Generation(EosTarget::NewGeneration())
+  , m_Revision(0)
+  , m_Version(0)
+  , m_Journal(journal)
+  , m_ChannelIndex(channelIndex)
+  , m_ChannelsSlot(EosTarget::GetPropGroupSlot(type, "channels", 8))
+  , m_PatchIndex((type == EosTarget::EOS_TARGET_PATCH) ? patchIndex : 0)
+  , m_LabelIndex(labelIndex)
+  , m_Columns((storage == PROPERTY_STORAGE_COLUMNS) ? (new EosPropertyColumns(EosTarget::MAX_PROP_GROUPS, stringPool)) : 0)
+  , m_TargetPool(memory)
+  , m_NumTargets(0)
+  , m_NumAwaiting(0)
+  , m_NumIncomplete(0)
+  , m_RefetchWindow(DEFAULT_REFETCH_WINDOW)
+  , m_NumCountsSent(0)
+  , m_NumCountsReceived(0)
+  , m_CountFenceQueued(false)
+  , m_ResyncMode(RESYNC_CLEAR)
+  , m_ResyncRequested(false)
+{
+  m_GetPath = "/eos/get/";
+  m_GetPath.append(EosTarget::GetNameForTargetType(m_Type));
+  if (m_Type == EosTarget::EOS_TARGET_CUE)
+  {
+    m_GetPath.append("/");
+    char buf[33];
+    sprintf(buf, "%d", m_ListId);
+    m_GetPath.append(buf);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetList::~EosTargetList()
+{
+  // owner journals the list removal
+  m_Journal = 0;
+  Clear();
+  delete m_Columns;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::Clear()
+{
+  m_Revision++;
+
+  if (!m_Targets.empty())
+    AddChange(EosChangeJournal::CHANGE_LIST_CLEARED, EosTarget::sTargetNumber(), 0, 0);
+
+  if (m_ChannelIndex && m_ChannelsSlot >= 0)
+    m_ChannelIndex->RemoveList(m_Type, m_ListId);
+
+  if (m_PatchIndex)
+    m_PatchIndex->Clear();
+
+  if (m_LabelIndex)
+    m_LabelIndex->RemoveList(m_Type, m_ListId);
+
+  for (TARGETS::const_iterator i = m_Targets.begin(); i != m_Targets.end(); i++)
+  {
+    const PARTS &parts = i->second.list;
+    for (PARTS::const_iterator j = parts.begin(); j != parts.end(); j++)
+      j->second->~EosTarget();
+  }
+  m_Targets.clear();
+  for (REFETCHES::const_iterator i = m_Refetches.begin(); i != m_Refetches.end(); i++)
+  {
+    const PARTS &parts = i->second.parts;
+    for (PARTS::const_iterator j = parts.begin(); j != parts.end(); j++)
+      j->second->~EosTarget();
+  }
+  m_Refetches.clear();
+  m_NumCountsSent = 0;
+  m_NumCountsReceived = 0;
+  m_CountFenceQueued = false;
+  m_TargetPool.Release();
+  m_NumTargets = 0;
+  m_Placeholders.clear();
+  m_NumAwaiting = 0;
+  m_NumIncomplete = 0;
+  if (m_Columns)
+    m_Columns->Clear();
+  m_UIDLookup.clear();
+  m_InitialSync = sInitialSyncInfo();
+  m_ResyncRequested = false;
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_UNINTIALIZED);
+  m_StatusInternal.SetValue(EosSyncStatus::SYNC_STATUS_UNINTIALIZED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::Tick(EosTcp &tcp, EosOsc &osc)
+{
+  switch (m_StatusInternal.GetValue())
+  {
+    case EosSyncStatus::SYNC_STATUS_UNINTIALIZED:
+    {
+      std::string path(m_GetPath);
+      path.append("/count");
+
+      if (osc.Send(tcp, OSCPacketWriter(path), /*immediate*/ false))
+        m_StatusInternal.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+    }
+    break;
+
+    case EosSyncStatus::SYNC_STATUS_COMPLETE:
+    {
+      if (m_Status.GetValue() == EosSyncStatus::SYNC_STATUS_RUNNING)
+      {
+        // Notify created placeholders for newly added targets, request info
+        for (TARGET_NUMBERS::iterator i = m_Placeholders.begin(); i != m_Placeholders.end();)
+        {
+          TARGETS::iterator j = m_Targets.find(*i);
+          if (j == m_Targets.end())
+          {
+            m_Placeholders.erase(i++);
+            continue;
+          }
+
+          char numStr[EosTarget::MAX_NUMBER_STRING_SIZE];
+          if (EosTarget::GetStringFromNumber(*i, numStr, sizeof(numStr)) != 0)
+          {
+            std::string path(m_GetPath);
+            path.append("/");
+            path.append(numStr);
+            if (osc.Send(tcp, OSCPacketWriter(path), /*immediate*/ false))
+            {
+              j->second.initialized = true;
+              m_NumAwaiting++;
+              m_Placeholders.erase(i++);
+              continue;
+            }
+          }
+
+          i++;
+        }
+
+        if (!m_Refetches.empty())
+          TickRefetches(tcp, osc);
+
+        bool recount = (m_InitialSync.recountQueued && !m_InitialSync.recountRequested);
+        if (recount || m_CountFenceQueued)
+        {
+          std::string path(m_GetPath);
+          path.append("/count");
+
+          if (osc.Send(tcp, OSCPacketWriter(path), /*immediate*/ false))
+          {
+            m_NumCountsSent++;
+            m_CountFenceQueued = false;
+            if (recount)
+            {
+              m_InitialSync.recountQueued = false;
+              m_InitialSync.recountRequested = true;
+              m_InitialSync.recountSeq = m_NumCountsSent;
+            }
+          }
+        }
+
+        bool allTargetsComplete = (m_Placeholders.empty() && m_NumAwaiting == 0 && m_NumIncomplete == 0 && m_Refetches.empty() && !m_InitialSync.recountQueued && !m_InitialSync.recountRequested);
+
+        if (allTargetsComplete)
+        {
+          if (m_InitialSync.complete)
+          {
+            m_Status.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
+          }
+          else if (m_NumTargets >= m_InitialSync.count)
+          {
+            m_InitialSync.complete = true;
+            m_Status.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
+          }
+          else if (m_InitialSync.edited)
+          {
+            // count again, its reply follows every index reply still in flight
+            m_InitialSync.recountQueued = true;
+          }
+        }
+      }
+    }
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::Recv(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &command, size_t offset)
+{
+  m_Revision++;
+
+  switch (m_StatusInternal.GetValue())
+  {
+    case EosSyncStatus::SYNC_STATUS_RUNNING:
+    {
+      if (command.path.compare(offset, std::string::npos, "/count") == 0)
+      {
+        if (command.args && command.argCount != 0)
+        {
+          unsigned int count = 0;
+          if (!command.args[0].GetUInt(count))
+          {
+            count = 0;
+            std::string text("ignored reply \"");
+            text.append(command.path);
+            text.append("\", missing argument");
+            log.AddError(text);
+          }
+
+          m_InitialSync.count = count;
+
+          // request all targets
+          RequestIndexes(tcp, osc, log, 0, m_InitialSync.count);
+
+          m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+          m_StatusInternal.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
+        }
+      }
+      else
+      {
+        std::string text("ignored reply \"");
+        text.append(command.path);
+        text.append("\", unhandled command");
+        log.AddError(text);
+      }
+    }
+    break;
+
+    case EosSyncStatus::SYNC_STATUS_COMPLETE:
+    {
+      if (m_NumCountsReceived != m_NumCountsSent && command.path.compare(offset, std::string::npos, "/count") == 0)
+      {
+        m_NumCountsReceived++;
+        if (m_InitialSync.recountRequested && m_NumCountsReceived == m_InitialSync.recountSeq)
+          RecvRecount(tcp, osc, log, command);
+      }
+      else if (offset < command.path.size() && command.path[offset] == OSC_ADDR_SEPARATOR)
+      {
+        // extract path data (target & list info)
+        EosTarget::sPathData pathData;
+        if (EosTarget::ExtractPathData(m_Type, command.path, offset + 1, pathData))
+        {
+          if (pathData.key.valid())
+          {
+            ProcessReceviedTarget(log, command, pathData);
+          }
+          else
+          {
+            std::string text("ignored reply \"");
+            text.append(command.path);
+            text.append("\", invalid target");
+            log.AddError(text);
+          }
+        }
+        else
+        {
+          std::string text("ignored reply \"");
+          text.append(command.path);
+          text.append("\", could not extract target");
+          log.AddError(text);
+        }
+      }
+      else
+      {
+        std::string text("ignored reply \"");
+        text.append(command.path);
+        text.append("\", unexpected format");
+        log.AddError(text);
+      }
+    }
+    break;
+
+    default:
+    {
+      if (log.IsEnabled(EosLog::LOG_MSG_TYPE_INFO))
+      {
+        std::string text("ignored unsolicited reply \"");
+        text.append(command.path);
+        text.append("\"");
+        log.AddInfo(text);
+      }
+    }
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::ProcessReceviedTarget(EosLog &log, EosOsc::sCommand &command, const EosTarget::sPathData &pathData)
+{
+  int part = pathData.key.part;
+  switch (m_Type)
+  {
+    case EosTarget::EOS_TARGET_CUE:
+    {
+      if (part < 0)
+      {
+        std::string text("Invalid part number specified \"");
+        text.append(command.path);
+        text.append("\"");
+        log.AddError(text);
+        return;
+      }
+    }
+    break;
+
+    case EosTarget::EOS_TARGET_PATCH:
+    {
+      if (part < 1)
+      {
+        std::string text("Invalid part number specified \"");
+        text.append(command.path);
+        text.append("\"");
+        log.AddError(text);
+        return;
+      }
+    }
+    break;
+
+    default:
+    {
+      if (part != 0)
+      {
+        std::string text("Invalid part number specified \"");
+        text.append(command.path);
+        text.append("\"");
+        log.AddWarning(text);
+        part = 0;
+      }
+    }
+    break;
+  }
+
+  bool baseTargetInfo = (pathData.groupSlot == EosTarget::PROP_GROUP_GENERAL);
+
+  // get UID
+  EosTarget::sUID uid;
+  if (baseTargetInfo && command.args && command.argCount > 1)
+  {
+    std::string uidStr;
+    if (command.args[1].GetString(uidStr))
+      EosTarget::GetUIDFromString(uidStr.c_str(), uidStr.size(), uid);
+  }
+
+  if (!m_Refetches.empty() && RecvRefetch(log, command, pathData, part, uid))
+    return;
+
+  // add or remove?
+  if (baseTargetInfo && !uid.valid())
+  {
+    // remove target
+    TARGETS::iterator i = m_Targets.find(pathData.key.num);
+    if (i != m_Targets.end())
+    {
+      PARTS &parts = i->second.list;
+      PARTS::iterator j = parts.find(part);
+      if (j != parts.end())
+      {
+        DeleteTarget(pathData.key.num, part, j->second);
+        parts.erase(j);
+        m_Status.SetDirty();
+      }
+      else if (parts.empty())
+      {
+        // placeholder target no longer exists
+        if (i->second.initialized)
+          m_NumAwaiting--;
+        else
+          m_Placeholders.erase(i->first);
+      }
+
+      if (parts.empty())
+      {
+        DropRefetch(i->first);
+        m_Targets.erase(i);
+      }
+    }
+  }
+  else
+  {
+    // add target
+    bool added = false;
+    EosTarget *target = 0;
+    TARGETS::iterator i = m_Targets.find(pathData.key.num);
+    if (i == m_Targets.end())
+    {
+      // nope, add it
+      sParts parts;
+      parts.initialized = true;
+      target = NewTarget(uid);
+      parts.list[part] = target;
+      m_Targets[pathData.key.num] = parts;
+      added = true;
+    }
+    else
+    {
+      sParts &parts = i->second;
+      if (!parts.initialized)
+      {
+        // reply arrived before the placeholder was requested
+        m_Placeholders.erase(i->first);
+        parts.initialized = true;
+      }
+      else if (parts.list.empty())
+        m_NumAwaiting--;
+      PARTS::iterator j = parts.list.find(part);
+      if (j == parts.list.end())
+      {
+        // nope, add it
+        target = NewTarget(uid);
+        parts.list[part] = target;
+        added = true;
+      }
+      else
+        target = j->second;
+    }
+
+    // forward incoming data to target
+    if (target)
+    {
+      bool wasComplete = (!added && target->GetStatus().GetValue() == EosSyncStatus::SYNC_STATUS_COMPLETE);
+
+      if (added)
+      {
+        m_NumTargets++;
+
+        if (!uid.valid())
+        {
+          std::string text("target reply missing UID \"");
+          text.append(command.path);
+          text.append("\"");
+          log.AddError(text);
+        }
+        else
+          m_UIDLookup[uid] = target;
+
+        m_Status.SetDirty();
+      }
+
+      target->Recv(log, command, pathData);
+      AddChange(added ? EosChangeJournal::CHANGE_TARGET_ADDED : EosChangeJournal::CHANGE_TARGET_MODIFIED, pathData.key.num, part, target, pathData.groupSlot);
+
+      if (m_ChannelIndex && pathData.groupSlot == m_ChannelsSlot && m_ChannelsSlot >= 0)
+        UpdateChannelIndex(pathData.key.num, part, *target);
+
+      if (m_PatchIndex && pathData.groupSlot == EosTarget::PROP_GROUP_GENERAL)
+        m_PatchIndex->Update(EosTarget::sTargetKey(pathData.key.num, part), *target);
+
+      if (m_LabelIndex && m_LabelIndex->IsEnabled() && pathData.groupSlot == EosTarget::PROP_GROUP_GENERAL)
+        m_LabelIndex->Update(GetTargetRef(pathData.key.num, part), *target);
+
+      bool isComplete = (target->GetStatus().GetValue() == EosSyncStatus::SYNC_STATUS_COMPLETE);
+      if (added)
+      {
+        if (!isComplete)
+          m_NumIncomplete++;
+      }
+      else if (wasComplete != isComplete)
+      {
+        if (isComplete)
+          m_NumIncomplete--;
+        else
+          m_NumIncomplete++;
+      }
+
+      m_Status.UpdateFromChild(target->GetStatus());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::Notify(EosLog &log, EosOsc::sCommand &command)
+{
+  m_Revision++;
+
+  // nothing requested yet, the count and every index reply will be sent after this change
+  if (!m_InitialSync.complete && m_StatusInternal.GetValue() != EosSyncStatus::SYNC_STATUS_COMPLETE)
+    return;
+
+  // extract targets from arguments
+  if (command.args && command.argCount > 1)  // NOTE: first arg is sequence number for UDP-only
+  {
+    bool badArgs = false;
+    TARGET_NUMBER_RANGES ranges;  // single numbers are ranges of one
+    TARGET_NUMBER_LIST listed;    // single numbers and range ends, may be new targets
+    for (size_t i = 1; i < command.argCount; i++)
     {
-      std::string path("/eos/get/");
-      path.append(EosTarget::GetNameForTargetType(m_Type));
-      if (m_Type == EosTarget::EOS_TARGET_CUE)
+      EosTarget::sTargetNumber first;
+      EosTarget::sTargetNumber last;
+      if (GetNotifyRange(command.args[i], first, last))
       {
-        path.append("/");
-        char buf[33];
-        sprintf(buf, "%d", m_ListId);
-        path.append(buf);
+        ranges.push_back(std::make_pair(first, last));
+        listed.push_back(first);
+        if (last != first)
+          listed.push_back(last);
       }
-      path.append("/count");
-
-      if (osc.Send(tcp, OSCPacketWriter(path), /*immediate*/ false))
-        m_StatusInternal.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+      else
+        badArgs = true;
     }
-    break;
 
-    case EosSyncStatus::SYNC_STATUS_COMPLETE:
+    if (badArgs)
     {
-      if (m_Status.GetValue() == EosSyncStatus::SYNC_STATUS_RUNNING)
+      std::string text("invalid arguments in notify \"");
+      text.append(command.path);
+      text.append("\"");
+      log.AddError(text);
+    }
+    else
+    {
+      // merge into a sorted interval set
+      std::sort(ranges.begin(), ranges.end());
+      size_t numRanges = 0;
+      for (size_t i = 0; i < ranges.size(); i++)
       {
-        bool allTargetsComplete = true;
-
-        for (TARGETS::iterator i = m_Targets.begin(); i != m_Targets.end(); i++)
+        if (numRanges != 0 && !(ranges[numRanges - 1].second < ranges[i].first))
         {
-          sParts &parts = i->second;
-          if (!parts.initialized)
-          {
-            // Notify created a placeholder for a newly added target, request info
-            std::string path("/eos/get/");
-            path.append(EosTarget::GetNameForTargetType(m_Type));
-            if (m_Type == EosTarget::EOS_TARGET_CUE)
-            {
-              path.append("/");
-              char buf[33];
-              sprintf(buf, "%d", m_ListId);
-              path.append(buf);
-            }
+          if (ranges[numRanges - 1].second < ranges[i].second)
+            ranges[numRanges - 1].second = ranges[i].second;
+        }
+        else
+          ranges[numRanges++] = ranges[i];
+      }
+      ranges.resize(numRanges);
 
-            std::string numStr;
-            EosTarget::GetStringFromNumber(i->first, numStr);
-            if (!numStr.empty())
-            {
-              path.append("/");
-              path.append(numStr);
-              if (osc.Send(tcp, OSCPacketWriter(path), /*immediate*/ false))
-                parts.initialized = true;
-            }
+      // existing targets changed, refetch them
+      for (TARGET_NUMBER_RANGES::const_iterator i = ranges.begin(); i != ranges.end(); i++)
+      {
+        for (TARGETS::iterator j = m_Targets.lower_bound(i->first); j != m_Targets.end() && !(i->second < j->first); j++)
+          InvalidateTarget(j);
+      }
 
-            allTargetsComplete = false;
-          }
-          else if (parts.list.empty())
-          {
-            // waiting for reply
-            allTargetsComplete = false;
-          }
-          else
-          {
-            for (PARTS::const_iterator j = parts.list.begin(); j != parts.list.end(); j++)
-            {
-              EosTarget *target = j->second;
-              if (target->GetStatus().GetValue() != EosSyncStatus::SYNC_STATUS_COMPLETE)
-                allTargetsComplete = false;
-            }
-          }
-        }
+      // new targets added, only numbers Eos listed get placeholders
+      for (TARGET_NUMBER_LIST::const_iterator i = listed.begin(); i != listed.end(); i++)
+        AddPlaceholder(*i);
 
-        if (allTargetsComplete)
-        {
-          if (m_InitialSync.complete)
-          {
-            m_Status.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
-          }
-          else if (m_NumTargets >= m_InitialSync.count)
-          {
-            m_InitialSync.complete = true;
-            m_Status.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
-          }
-        }
+      // Index replies still to come were sent after this change and are current,
+      // but inserts and deletes shift which targets they refer to, so count again
+      if (!m_InitialSync.complete)
+      {
+        m_InitialSync.recountQueued = true;
+        m_InitialSync.edited = true;
+        m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
       }
     }
-    break;
+  }
+  else
+  {
+    // no arguments, so assume entire list is dirty
+    if (!m_InitialSync.complete)
+    {
+      std::string text("Notified during initial sync \"");
+      text.append(command.path);
+      text.append("\", restarting...");
+      log.AddInfo(text);
+    }
+    Resync();
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTargetList::Recv(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &command)
+void EosTargetList::Resync()
 {
-  switch (m_StatusInternal.GetValue())
+  // nothing complete to keep serving before the initial sync
+  if (m_ResyncMode == RESYNC_SHADOW && m_InitialSync.complete)
+    m_ResyncRequested = true;
+  else
+    Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTargetList::TakeResyncRequest()
+{
+  bool requested = m_ResyncRequested;
+  m_ResyncRequested = false;
+  return requested;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::Attach(EosChangeJournal *journal, EosChannelIndex *channelIndex, EosPatchIndex *patchIndex, EosLabelIndex *labelIndex)
+{
+  m_Journal = journal;
+  m_ChannelIndex = channelIndex;
+  m_PatchIndex = ((m_Type == EosTarget::EOS_TARGET_PATCH) ? patchIndex : 0);
+  m_LabelIndex = labelIndex;
+
+  // index targets synced while detached, owner journals the list as a whole
+  for (TARGETS::const_iterator i = m_Targets.begin(); i != m_Targets.end(); i++)
   {
-    case EosSyncStatus::SYNC_STATUS_RUNNING:
+    const PARTS &parts = i->second.list;
+    for (PARTS::const_iterator j = parts.begin(); j != parts.end(); j++)
     {
-      std::string path("/eos/out/get/");
-      path.append(EosTarget::GetNameForTargetType(m_Type));
-      if (m_Type == EosTarget::EOS_TARGET_CUE)
-      {
-        path.append("/");
-        char buf[33];
-        sprintf(buf, "%d", m_ListId);
-        path.append(buf);
-      }
-      std::string countPath(path);
-      countPath.append("/count");
-      if (command.path == countPath)
-      {
-        if (command.args && command.argCount != 0)
-        {
-          unsigned int count = 0;
-          if (!command.args[0].GetUInt(count))
-          {
-            count = 0;
-            std::string text("ignored reply \"");
-            text.append(command.path);
-            text.append("\", missing argument");
-            log.AddError(text);
-          }
+      if (m_ChannelIndex && m_ChannelsSlot >= 0)
+        UpdateChannelIndex(i->first, j->first, *j->second);
 
-          m_InitialSync.count = count;
+      if (m_PatchIndex)
+        m_PatchIndex->Update(EosTarget::sTargetKey(i->first, j->first), *j->second);
 
-          // request all targets
-          path = "/eos/get/";
-          path.append(EosTarget::GetNameForTargetType(m_Type));
-          if (m_Type == EosTarget::EOS_TARGET_CUE)
-          {
-            path.append("/");
-            char buf[33];
-            sprintf(buf, "%d", m_ListId);
-            path.append(buf);
-          }
-          path.append("/index/");
-          for (size_t i = 0; i < m_InitialSync.count; i++)
-          {
-            char buf[33];
-            sprintf(buf, "%u", static_cast<unsigned int>(i));
-            std::string indexPath(path);
-            indexPath.append(buf);
+      if (m_LabelIndex && m_LabelIndex->IsEnabled())
+        m_LabelIndex->Update(GetTargetRef(i->first, j->first), *j->second);
+    }
+  }
 
-            if (!osc.Send(tcp, OSCPacketWriter(indexPath), /*immediate*/ false))
-            {
-              std::string text("failed to send command \"");
-              text.append(indexPath);
-              text.append("\"");
-              log.AddError(text);
-            }
-          }
+  m_Status.SetDirty();
+}
 
-          m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
-          m_StatusInternal.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
-        }
-      }
-      else
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::InvalidateTarget(TARGETS::iterator i)
+{
+  sParts &parts = i->second;
+  if (!parts.list.empty())
+  {
+    QueueRefetch(i->first);
+    return;
+  }
+
+  // placeholder, possibly requested already, fetch it again
+  if (parts.initialized)
+    m_NumAwaiting--;
+  parts.initialized = false;
+  m_Placeholders.insert(i->first);
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::AddPlaceholder(const EosTarget::sTargetNumber &num)
+{
+  TARGETS::iterator i = m_Targets.find(num);
+  if (i != m_Targets.end())
+    return;
+
+  m_Targets[num] = sParts();
+  m_Placeholders.insert(num);
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::QueueRefetch(const EosTarget::sTargetNumber &num)
+{
+  REFETCHES::iterator i = m_Refetches.find(num);
+  if (i == m_Refetches.end())
+    m_Refetches[num].due = (EosTimer::GetTimestamp() + m_RefetchWindow);
+  else if (i->second.requested)
+    i->second.again = true;
+  // else already queued, coalesced
+
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::TickRefetches(EosTcp &tcp, EosOsc &osc)
+{
+  unsigned int now = EosTimer::GetTimestamp();
+  for (REFETCHES::iterator i = m_Refetches.begin(); i != m_Refetches.end();)
+  {
+    sRefetch &refetch = i->second;
+    if (refetch.requested)
+    {
+      // A multi-part reply may span several receives, so wait for the /count sent after
+      // the get: once it is answered every part has arrived and missing ones are gone
+      if (static_cast<int>(m_NumCountsReceived - refetch.fence) >= 0)
       {
-        std::string text("ignored reply \"");
-        text.append(command.path);
-        text.append("\", unhandled command");
-        log.AddError(text);
+        bool complete = !refetch.parts.empty();
+        for (PARTS::const_iterator j = refetch.parts.begin(); complete && j != refetch.parts.end(); j++)
+          complete = (j->second->GetStatus().GetValue() == EosSyncStatus::SYNC_STATUS_COMPLETE);
+
+        if (complete)
+        {
+          SwapRefetch(i++);
+          continue;
+        }
+
+        // reply missing or cut short, ask again
+        for (PARTS::const_iterator j = refetch.parts.begin(); j != refetch.parts.end(); j++)
+          FreeTarget(j->second);
+        refetch.parts.clear();
+        refetch.requested = false;
+        refetch.due = now;
       }
     }
-    break;
-
-    case EosSyncStatus::SYNC_STATUS_COMPLETE:
+    else if (static_cast<int>(now - refetch.due) >= 0)
     {
-      std::string path("/eos/out/get/");
-      path.append(EosTarget::GetNameForTargetType(m_Type));
-      if (m_Type == EosTarget::EOS_TARGET_CUE)
+      char numStr[EosTarget::MAX_NUMBER_STRING_SIZE];
+      if (EosTarget::GetStringFromNumber(i->first, numStr, sizeof(numStr)) != 0)
       {
+        std::string path(m_GetPath);
         path.append("/");
-        char buf[33];
-        sprintf(buf, "%d", m_ListId);
-        path.append(buf);
-      }
-      path.append("/");
-      if (command.path.find(path) == 0)
-      {
-        // extract path data (target & list info)
-        EosTarget::sPathData pathData;
-        if (EosTarget::ExtractPathData(command.path, path.size(), pathData))
-        {
-          if (pathData.key.valid())
-          {
-            ProcessReceviedTarget(log, command, pathData);
-          }
-          else
-          {
-            std::string text("ignored reply \"");
-            text.append(command.path);
-            text.append("\", invalid target");
-            log.AddError(text);
-          }
-        }
-        else
+        path.append(numStr);
+        if (osc.Send(tcp, OSCPacketWriter(path), /*immediate*/ false))
         {
-          std::string text("ignored reply \"");
-          text.append(command.path);
-          text.append("\", could not extract target");
-          log.AddError(text);
+          refetch.requested = true;
+          refetch.fence = (m_NumCountsSent + 1);
+          m_CountFenceQueued = true;
         }
       }
-      else
+    }
+
+    i++;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTargetList::RecvRefetch(EosLog &log, EosOsc::sCommand &command, const EosTarget::sPathData &pathData, int part, const EosTarget::sUID &uid)
+{
+  REFETCHES::iterator i = m_Refetches.find(pathData.key.num);
+  if (i == m_Refetches.end() || !i->second.requested)
+    return false;
+
+  PARTS &parts = i->second.parts;
+  if (pathData.groupSlot == EosTarget::PROP_GROUP_GENERAL && !uid.valid())
+  {
+    PARTS::iterator j = parts.find(part);
+    if (j != parts.end())
+    {
+      FreeTarget(j->second);
+      parts.erase(j);
+    }
+
+    if (parts.empty())
+    {
+      // target no longer exists, remove it now
+      TARGETS::iterator k = m_Targets.find(pathData.key.num);
+      if (k != m_Targets.end())
       {
-        std::string text("ignored reply \"");
-        text.append(command.path);
-        text.append("\", unexpected format");
-        log.AddError(text);
+        for (PARTS::iterator l = k->second.list.begin(); l != k->second.list.end(); l++)
+          DeleteTarget(k->first, l->first, l->second);
+        m_Targets.erase(k);
+        m_Status.SetDirty();
       }
+
+      bool again = i->second.again;
+      m_Refetches.erase(i);
+      if (again)
+        AddPlaceholder(pathData.key.num);
     }
-    break;
 
-    default:
+    return true;
+  }
+
+  EosTarget *target = 0;
+  PARTS::iterator j = parts.find(part);
+  if (j == parts.end())
+  {
+    if (!uid.valid() && pathData.groupSlot == EosTarget::PROP_GROUP_GENERAL)
     {
-      std::string text("ignored unsolicited reply \"");
+      std::string text("target reply missing UID \"");
       text.append(command.path);
       text.append("\"");
-      log.AddInfo(text);
+      log.AddError(text);
     }
-    break;
+
+    target = NewTarget(uid);
+    parts[part] = target;
   }
+  else
+    target = j->second;
+
+  target->Recv(log, command, pathData);
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTargetList::ProcessReceviedTarget(EosLog &log, EosOsc::sCommand &command, const EosTarget::sPathData &pathData)
+void EosTargetList::RecvRecount(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &command)
 {
-  int part = pathData.key.part;
-  switch (m_Type)
+  m_InitialSync.recountRequested = false;
+
+  unsigned int count = 0;
+  if (!command.args || command.argCount == 0 || !command.args[0].GetUInt(count))
   {
-    case EosTarget::EOS_TARGET_CUE:
-    {
-      if (part < 0)
-      {
-        std::string text("Invalid part number specified \"");
-        text.append(command.path);
-        text.append("\"");
-        log.AddError(text);
-        return;
-      }
-    }
-    break;
+    std::string text("ignored reply \"");
+    text.append(command.path);
+    text.append("\", missing argument");
+    log.AddError(text);
+    return;
+  }
 
-    case EosTarget::EOS_TARGET_PATCH:
+  // targets inserted during sync shift the rest of the list towards the end,
+  // so the last ones are only reachable through indexes not yet requested
+  if (count > m_InitialSync.count)
+    RequestIndexes(tcp, osc, log, m_InitialSync.count, count);
+  else if (m_NumTargets < count && m_Placeholders.empty() && m_NumAwaiting == 0 && m_Refetches.empty())
+  {
+    // Every index reply sent before this one has arrived and targets are still missing:
+    // deletes shifted them into indexes already answered, so request them all again.
+    // Replies for targets already here are harmless.
+    if (log.IsEnabled(EosLog::LOG_MSG_TYPE_INFO))
     {
-      if (part < 1)
-      {
-        std::string text("Invalid part number specified \"");
-        text.append(command.path);
-        text.append("\"");
-        log.AddError(text);
-        return;
-      }
+      std::string text("targets shifted during initial sync \"");
+      text.append(command.path);
+      text.append("\", requesting all indexes again");
+      log.AddInfo(text);
     }
-    break;
+    RequestIndexes(tcp, osc, log, 0, count);
+  }
 
-    default:
+  m_InitialSync.count = count;
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::RequestIndexes(EosTcp &tcp, EosOsc &osc, EosLog &log, size_t first, size_t last)
+{
+  std::string path(m_GetPath);
+  path.append("/index/");
+  for (size_t i = first; i < last; i++)
+  {
+    char buf[33];
+    sprintf(buf, "%u", static_cast<unsigned int>(i));
+    std::string indexPath(path);
+    indexPath.append(buf);
+
+    if (!osc.Send(tcp, OSCPacketWriter(indexPath), /*immediate*/ false))
     {
-      if (part != 0)
-      {
-        std::string text("Invalid part number specified \"");
-        text.append(command.path);
-        text.append("\"");
-        log.AddWarning(text);
-        part = 0;
-      }
+      std::string text("failed to send command \"");
+      text.append(indexPath);
+      text.append("\"");
+      log.AddError(text);
     }
-    break;
   }
+}
 
-  bool baseTargetInfo = pathData.group.empty();
+////////////////////////////////////////////////////////////////////////////////
 
-  // get UID
-  std::string uid;
-  if (baseTargetInfo && command.args && command.argCount > 1)
+void EosTargetList::SwapRefetch(REFETCHES::iterator i)
+{
+  const EosTarget::sTargetNumber num = i->first;
+  sRefetch &refetch = i->second;
+
+  TARGETS::iterator t = m_Targets.find(num);
+  if (t == m_Targets.end())
   {
-    if (!command.args[1].GetString(uid))
-      uid.clear();
+    t = m_Targets.insert(std::make_pair(num, sParts())).first;
+    t->second.initialized = true;
   }
 
-  // add or remove?
-  if (baseTargetInfo && uid.empty())
+  // parts gone from the reply
+  PARTS &parts = t->second.list;
+  for (PARTS::iterator j = parts.begin(); j != parts.end();)
   {
-    // remove target
-    TARGETS::iterator i = m_Targets.find(pathData.key.num);
-    if (i != m_Targets.end())
+    if (refetch.parts.find(j->first) == refetch.parts.end())
     {
-      PARTS &parts = i->second.list;
-      PARTS::iterator j = parts.find(part);
-      if (j != parts.end())
-      {
-        DeleteTarget(j->second);
-        parts.erase(j);
-        m_Status.SetDirty();
-      }
-
-      if (parts.empty())
-        m_Targets.erase(i);
+      DeleteTarget(num, j->first, j->second);
+      j = parts.erase(j);
     }
+    else
+      j++;
   }
-  else
+
+  for (PARTS::const_iterator j = refetch.parts.begin(); j != refetch.parts.end(); j++)
   {
-    // add target
-    bool added = false;
-    EosTarget *target = 0;
-    TARGETS::iterator i = m_Targets.find(pathData.key.num);
-    if (i == m_Targets.end())
-    {
-      // nope, add it
-      sParts parts;
-      parts.initialized = true;
-      target = new EosTarget(m_Type);
-      parts.list[part] = target;
-      m_Targets[pathData.key.num] = parts;
-      added = true;
-    }
+    EosTarget *target = j->second;
+    PARTS::iterator k = parts.find(j->first);
+    bool added = (k == parts.end());
+    if (added)
+      parts[j->first] = target;
     else
     {
-      sParts &parts = i->second;
-      parts.initialized = true;
-      PARTS::iterator j = parts.list.find(part);
-      if (j == parts.list.end())
-      {
-        // nope, add it
-        target = new EosTarget(m_Type);
-        parts.list[part] = target;
-        added = true;
-      }
-      else
-        target = j->second;
+      ReleaseTarget(k->second);
+      k->second = target;
     }
 
-    // forward incoming data to target
-    if (target)
-    {
-      if (added)
-      {
-        m_NumTargets++;
+    m_NumTargets++;
+    if (target->GetUID().valid())
+      m_UIDLookup[target->GetUID()] = target;
 
-        if (uid.empty())
-        {
-          std::string text("target reply missing UID \"");
-          text.append(command.path);
-          text.append("\"");
-          log.AddError(text);
-        }
-        else
-          m_UIDLookup[uid] = target;
+    AddChange(added ? EosChangeJournal::CHANGE_TARGET_ADDED : EosChangeJournal::CHANGE_TARGET_MODIFIED, num, j->first, target);
 
-        m_Status.SetDirty();
-      }
+    if (m_ChannelIndex && m_ChannelsSlot >= 0)
+      UpdateChannelIndex(num, j->first, *target);
 
-      target->Recv(log, command, pathData);
-      m_Status.UpdateFromChild(target->GetStatus());
-    }
+    if (m_PatchIndex)
+      m_PatchIndex->Update(EosTarget::sTargetKey(num, j->first), *target);
+
+    if (m_LabelIndex && m_LabelIndex->IsEnabled())
+      m_LabelIndex->Update(GetTargetRef(num, j->first), *target);
+  }
+
+  m_Status.SetDirty();
+
+  if (refetch.again)
+  {
+    // notified after the request went out, fetch once more
+    refetch.parts.clear();
+    refetch.requested = false;
+    refetch.again = false;
+    refetch.due = (EosTimer::GetTimestamp() + m_RefetchWindow);
   }
+  else
+    m_Refetches.erase(i);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTargetList::Notify(EosLog &log, EosOsc::sCommand &command)
+void EosTargetList::DropRefetch(const EosTarget::sTargetNumber &num)
 {
-  if (m_InitialSync.complete)
-  {
-    // extract targets from arguments
-    if (command.args && command.argCount > 1)  // NOTE: first arg is sequence number for UDP-only
-    {
-      bool badArgs = false;
-      std::set<EosTarget::sDecimalNumber> targets;
-      for (size_t i = 1; i < command.argCount; i++)
-      {
-        OSCArgument &arg = command.args[i];
-        double d;
-        if (arg.GetDouble(d))
-        {
-          std::string str;
-          if (arg.GetString(str))
-          {
-            EosTarget::sDecimalNumber num;
-            EosTarget::GetNumberFromString(str, num);
-            targets.insert(num);
-          }
-        }
-        else
-        {
-          // not a simple number, so expecting a range "a-b"
-          bool gotRange = false;
+  REFETCHES::iterator i = m_Refetches.find(num);
+  if (i == m_Refetches.end())
+    return;
 
-          std::string str;
-          if (arg.GetString(str))
-          {
-            if (str.size() > 2)
-            {
-              size_t n = str.find("-");
-              if (n != std::string::npos && n != 0 && n < (str.size() - 1))
-              {
-                std::string range(str, 0, n++);
-                const char *s = range.c_str();
-                if (OSCArgument::IsIntString(s))
-                {
-                  int rangeStart = atoi(s);
-                  range = str.substr(n, str.size() - n);
-                  s = range.c_str();
-                  if (OSCArgument::IsIntString(s))
-                  {
-                    int rangeEnd = atoi(s);
-                    if (rangeStart <= rangeEnd)
-                    {
-                      for (int j = rangeStart; j <= rangeEnd; j++)
-                        targets.insert(j);
-                      gotRange = true;
-                    }
-                  }
-                }
-              }
-            }
-          }
+  for (PARTS::const_iterator j = i->second.parts.begin(); j != i->second.parts.end(); j++)
+    FreeTarget(j->second);
+  m_Refetches.erase(i);
+}
 
-          if (!gotRange)
-            badArgs = true;
-        }
-      }
+////////////////////////////////////////////////////////////////////////////////
 
-      if (badArgs)
-      {
-        std::string text("invalid arguments in notify \"");
-        text.append(command.path);
-        text.append("\"");
-        log.AddError(text);
-      }
-      else
+bool EosTargetList::GetNotifyRange(const OSCArgument &arg, EosTarget::sTargetNumber &first, EosTarget::sTargetNumber &last)
+{
+  switch (arg.GetType())
+  {
+    case OSCArgument::OSC_TYPE_STRING:
+    {
+      // parsed in place, "-5" is a number but "1-5" and "-5--3" are ranges
+      const char *str = arg.GetRaw();
+      if (!str)
+        return false;
+
+      size_t len = strlen(str);
+      const char *dash = ((len > 1) ? static_cast<const char *>(memchr(str + 1, '-', len - 1)) : 0);
+      if (!dash)
       {
-        for (std::set<EosTarget::sDecimalNumber>::const_iterator i = targets.begin(); i != targets.end(); i++)
-        {
-          const EosTarget::sDecimalNumber &targetNumber = *i;
-          TARGETS::iterator j = m_Targets.find(targetNumber);
-          if (j == m_Targets.end())
-          {
-            // new target added, insert placeholder
-            m_Targets[targetNumber] = sParts();
-            m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
-          }
-          else
-          {
-            // existing target changed, remove exising and leave placeholder
-            sParts &parts = j->second;
-            for (PARTS::iterator k = parts.list.begin(); k != parts.list.end(); k++)
-              DeleteTarget(k->second);
-            parts.list.clear();
-            parts.initialized = false;
-            m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
-          }
-        }
+        if (!EosTarget::GetNumberFromString(str, len, first))
+          return false;
+        last = first;
+        return true;
       }
+
+      return (EosTarget::GetNumberFromString(str, static_cast<size_t>(dash - str), first) && EosTarget::GetNumberFromString(dash + 1, static_cast<size_t>((str + len) - (dash + 1)), last) &&
+              !(last < first));
     }
-    else
+
+    case OSCArgument::OSC_TYPE_CHAR:
+    case OSCArgument::OSC_TYPE_INT32:
+    {
+      int n;
+      if (!arg.GetInt(n))
+        return false;
+      first = last = EosTarget::sTargetNumber(n);
+      return true;
+    }
+
+    default:
     {
-      // no arguments, so assume entire list is dirty
-      Clear();
+      // floats and the rest, formatted like a reply argument
+      std::string str;
+      if (!arg.GetString(str) || !EosTarget::GetNumberFromString(str.c_str(), str.size(), first))
+        return false;
+      last = first;
+      return true;
     }
   }
-  else
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTarget *EosTargetList::NewTarget(const EosTarget::sUID &uid)
+{
+  return new (m_TargetPool.Allocate(sizeof(EosTarget))) EosTarget(m_Type, m_Columns, uid);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::DeleteTarget(const EosTarget::sTargetNumber &num, int part, EosTarget *target)
+{
+  AddChange(EosChangeJournal::CHANGE_TARGET_REMOVED, num, part, 0);
+
+  if (m_ChannelIndex && m_ChannelsSlot >= 0)
+    m_ChannelIndex->Remove(GetTargetRef(num, part));
+
+  if (m_PatchIndex)
+    m_PatchIndex->Remove(EosTarget::sTargetKey(num, part));
+
+  if (m_LabelIndex)
+    m_LabelIndex->Remove(GetTargetRef(num, part));
+
+  ReleaseTarget(target);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::ReleaseTarget(EosTarget *target)
+{
+  if (target->GetUID().valid())
   {
-    // notified during initial sync, must start over
-    std::string text("Notified during initial sync \"");
-    text.append(command.path);
-    text.append("\", restarting...");
-    log.AddInfo(text);
-    Clear();
+    UID_LOOKUP::iterator i = m_UIDLookup.find(target->GetUID());
+    if (i != m_UIDLookup.end() && i->second == target)
+      m_UIDLookup.erase(i);
   }
+
+  if (target->GetStatus().GetValue() != EosSyncStatus::SYNC_STATUS_COMPLETE)
+    m_NumIncomplete--;
+
+  FreeTarget(target);
+  m_NumTargets--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::FreeTarget(EosTarget *target)
+{
+  target->~EosTarget();
+  m_TargetPool.Deallocate(target, sizeof(EosTarget));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetList::UpdateChannelIndex(const EosTarget::sTargetNumber &num, int part, const EosTarget &target)
+{
+  EosChannelSet channels;
+  EosChannelIndex::GetChannelsFromTarget(target, static_cast<unsigned int>(m_ChannelsSlot), channels);
+  m_ChannelIndex->Set(GetTargetRef(num, part), channels);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosChannelIndex::sRef EosTargetList::GetTargetRef(const EosTarget::sTargetNumber &num, int part) const
+{
+  EosChannelIndex::sRef ref;
+  ref.type = m_Type;
+  ref.listId = m_ListId;
+  ref.key = EosTarget::sTargetKey(num, part);
+  return ref;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosTargetList::DeleteTarget(EosTarget *target)
+void EosTargetList::AddChange(EosChangeJournal::EnumChangeKind kind, const EosTarget::sTargetNumber &num, int part, EosTarget *target, int groupSlot)
 {
-  for (UID_LOOKUP::iterator i = m_UIDLookup.begin(); i != m_UIDLookup.end();)
+  if (m_Journal)
   {
-    if (i->second == target)
-      m_UIDLookup.erase(i++);
-    else
-      i++;
+    m_Version = m_Journal->Add(kind, m_Type, m_ListId, num, part, groupSlot);
+    if (target)
+      target->SetVersion(m_Version);
   }
+}
 
-  delete target;
-  m_NumTargets--;
+////////////////////////////////////////////////////////////////////////////////
+
+const EosTarget *EosTargetList::GetTargetByUID(const EosTarget::sUID &uid) const
+{
+  UID_LOOKUP::const_iterator i = m_UIDLookup.find(uid);
+  return ((i == m_UIDLookup.end()) ? 0 : i->second);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const EosTarget *EosTargetList::GetTargetByUID(const std::string &uid) const
+{
+  EosTarget::sUID key;
+  if (EosTarget::GetUIDFromString(uid.c_str(), uid.size(), key))
+    return GetTargetByUID(key);
+
+  return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1146,7 +2959,17 @@ void EosTargetList::InitializeAsDummy()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosSyncData::EosSyncData()
+EosSyncData::EosSyncData(EosMemoryResource *memory)
+  : m_PropertyStorage(EosTargetList::PROPERTY_STORAGE_STRINGS)
+  , m_Memory(memory ? memory : (&EosMemoryResource::GetDefault()))
+  , m_StringPool(EosStringPool::DEFAULT_BLOCK_SIZE, m_Memory)
+  , m_DataSnapshots(new EosDataSnapshotManager())
+  , m_DataSnapshotsEnabled(false)
+  , m_DataSnapshotVersion(0)
+  , m_RefetchWindow(EosTargetList::DEFAULT_REFETCH_WINDOW)
+  , m_ResyncMode(EosTargetList::RESYNC_CLEAR)
+  , m_ResyncShow(false)
+  , m_ResyncShowLoaded(false)
 {
   for (unsigned int i = 0; i < EosTarget::EOS_TARGET_COUNT; i++)
   {
@@ -1159,20 +2982,33 @@ EosSyncData::EosSyncData()
 EosSyncData::~EosSyncData()
 {
   Clear();
+  delete m_DataSnapshots;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void EosSyncData::Clear()
 {
-  for (SHOW_DATA::const_iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
+  ClearResync();
+
+  if (!m_ShowData.empty())
+    m_Journal.Add(EosChangeJournal::CHANGE_SHOW_CLEARED, EosTarget::EOS_TARGET_INVALID, 0);
+
+  ClearShowData(m_ShowData);
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_UNINTIALIZED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::ClearShowData(SHOW_DATA &showData)
+{
+  for (SHOW_DATA::const_iterator i = showData.begin(); i != showData.end(); i++)
   {
     const TARGETLIST_DATA &targetListData = i->second;
     for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
       delete j->second;
   }
-  m_ShowData.clear();
-  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_UNINTIALIZED);
+  showData.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1180,15 +3016,20 @@ void EosSyncData::Clear()
 void EosSyncData::Initialize()
 {
   Clear();
+  InitializeShowData(m_ShowData);
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
+void EosSyncData::InitializeShowData(SHOW_DATA &showData)
+{
   // add default targets
   for (EosTarget::EnumEosTargetType type : m_Types)
   {
     if (type != EosTarget::EOS_TARGET_CUE)
-      m_ShowData[type][0] = new EosTargetList(type, /*listId*/ 0);
+      showData[type][0] = NewTargetList(type, /*listId*/ 0, /*shadow*/ (&showData == &m_Resync));
   }
-
-  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1213,7 +3054,32 @@ void EosSyncData::TickRunning(EosTcp &tcp, EosOsc &osc, EosLog &log)
 {
   bool allShowDataComplete = true;
 
-  for (SHOW_DATA::const_iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
+  // show being replaced gets no more replies
+  if (!m_ResyncShow)
+    TickShowData(m_ShowData, tcp, osc, allShowDataComplete);
+
+  if (!m_Resync.empty())
+  {
+    bool allResyncComplete = true;
+    TickShowData(m_Resync, tcp, osc, allResyncComplete);
+    if (allResyncComplete)
+      SwapResync(log);
+    else
+      allShowDataComplete = false;
+  }
+
+  if (allShowDataComplete)
+  {
+    m_Status.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
+    log.AddInfo("synchronization complete");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::TickShowData(SHOW_DATA &showData, EosTcp &tcp, EosOsc &osc, bool &allShowDataComplete)
+{
+  for (SHOW_DATA::const_iterator i = showData.begin(); i != showData.end(); i++)
   {
     const TARGETLIST_DATA &targetListData = i->second;
     for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
@@ -1221,6 +3087,10 @@ void EosSyncData::TickRunning(EosTcp &tcp, EosOsc &osc, EosLog &log)
       EosTargetList *t = j->second;
       if (t->GetStatus().GetValue() != EosSyncStatus::SYNC_STATUS_COMPLETE)
       {
+        // replies go to its resync list, which replaces it once complete
+        if (&showData == &m_ShowData && &GetSyncShowData(i->first, j->first) == &m_Resync)
+          continue;
+
         bool wasInitialSyncComplete = t->GetInitialSync().complete;
 
         t->Tick(tcp, osc);
@@ -1228,25 +3098,21 @@ void EosSyncData::TickRunning(EosTcp &tcp, EosOsc &osc, EosLog &log)
         m_Status.UpdateFromChild(t->GetStatus());
 
         if (!wasInitialSyncComplete && t->GetInitialSync().complete)
-          OnTargeListInitialSyncComplete(*t);
+          OnTargeListInitialSyncComplete(showData, *t);
 
         if (t->GetStatus().GetValue() != EosSyncStatus::SYNC_STATUS_COMPLETE)
           allShowDataComplete = false;
       }
     }
   }
-
-  if (allShowDataComplete)
-  {
-    m_Status.SetValue(EosSyncStatus::SYNC_STATUS_COMPLETE);
-    log.AddInfo("synchronization complete");
-  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosSyncData::OnTargeListInitialSyncComplete(EosTargetList &targetList)
+void EosSyncData::OnTargeListInitialSyncComplete(SHOW_DATA &showData, EosTargetList &targetList)
 {
+  bool shadow = (&showData == &m_Resync);
+
   if (targetList.GetType() == EosTarget::EOS_TARGET_CUELIST)
   {
     // add all cues in the cuelist
@@ -1255,11 +3121,11 @@ void EosSyncData::OnTargeListInitialSyncComplete(EosTargetList &targetList)
     {
       for (EosTargetList::TARGETS::const_iterator i = targets.begin(); i != targets.end(); i++)
       {
-        int cueListId = i->first.whole;
-        SHOW_DATA::iterator j = m_ShowData.find(EosTarget::EOS_TARGET_CUE);
-        if (j == m_ShowData.end())
+        int cueListId = i->first.GetWhole();
+        SHOW_DATA::iterator j = showData.find(EosTarget::EOS_TARGET_CUE);
+        if (j == showData.end())
         {
-          m_ShowData[EosTarget::EOS_TARGET_CUE][cueListId] = new EosTargetList(EosTarget::EOS_TARGET_CUE, cueListId);
+          showData[EosTarget::EOS_TARGET_CUE][cueListId] = NewTargetList(EosTarget::EOS_TARGET_CUE, cueListId, shadow);
         }
         else
         {
@@ -1267,12 +3133,12 @@ void EosSyncData::OnTargeListInitialSyncComplete(EosTargetList &targetList)
           TARGETLIST_DATA::iterator k = targetListData.find(cueListId);
           if (k == targetListData.end())
           {
-            targetListData[cueListId] = new EosTargetList(EosTarget::EOS_TARGET_CUE, cueListId);
+            targetListData[cueListId] = NewTargetList(EosTarget::EOS_TARGET_CUE, cueListId, shadow);
           }
           else
           {
-            delete k->second;
-            k->second = new EosTargetList(EosTarget::EOS_TARGET_CUE, cueListId);
+            DeleteTargetList(k->second, shadow);
+            k->second = NewTargetList(EosTarget::EOS_TARGET_CUE, cueListId, shadow);
           }
         }
       }
@@ -1281,12 +3147,12 @@ void EosSyncData::OnTargeListInitialSyncComplete(EosTargetList &targetList)
     {
       // no cues, so add dummy list
       int cueListId = 0;
-      SHOW_DATA::iterator j = m_ShowData.find(EosTarget::EOS_TARGET_CUE);
-      if (j == m_ShowData.end())
+      SHOW_DATA::iterator j = showData.find(EosTarget::EOS_TARGET_CUE);
+      if (j == showData.end())
       {
-        EosTargetList *dummyCueList = new EosTargetList(EosTarget::EOS_TARGET_CUE, cueListId);
+        EosTargetList *dummyCueList = NewTargetList(EosTarget::EOS_TARGET_CUE, cueListId, shadow);
         dummyCueList->InitializeAsDummy();
-        m_ShowData[EosTarget::EOS_TARGET_CUE][cueListId] = dummyCueList;
+        showData[EosTarget::EOS_TARGET_CUE][cueListId] = dummyCueList;
       }
     }
   }
@@ -1302,7 +3168,7 @@ void EosSyncData::Recv(EosTcp &tcp, EosOsc &osc, EosLog &log)
   while (!cmdQ.empty())
   {
     RecvCmd(tcp, osc, log, *cmdQ.front());
-    delete cmdQ.front();
+    osc.FreeCommand(cmdQ.front());
     cmdQ.pop();
   }
 }
@@ -1311,53 +3177,30 @@ void EosSyncData::Recv(EosTcp &tcp, EosOsc &osc, EosLog &log)
 
 void EosSyncData::RecvCmd(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &cmd)
 {
+  sRoute route;
+  GetRoute(cmd.path, route);
+
   // is this a /get reply?
-  static const std::string sGetReply("/eos/out/get/");
-  if (cmd.path.find(sGetReply) == 0)
+  if (route.routeType == ROUTE_GET_REPLY)
   {
     if (m_Status.GetValue() == EosSyncStatus::SYNC_STATUS_RUNNING)
     {
       // route to proper target
       bool found = false;
-      for (SHOW_DATA::iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
+      SHOW_DATA &showData = GetSyncShowData(route.type, route.listId);
+      SHOW_DATA::iterator i = showData.find(route.type);
+      if (i != showData.end())
       {
         TARGETLIST_DATA &targetData = i->second;
-        EosTarget::EnumEosTargetType type = i->first;
-        std::string replyPath(sGetReply);
-        replyPath.append(EosTarget::GetNameForTargetType(type));
-        if (cmd.path.find(replyPath) == 0)
+        TARGETLIST_DATA::iterator j = targetData.find(route.listId);
+        if (j != targetData.end())
         {
-          // found the matching target
-
-          // get listId when applicable
-          int listId = 0;
-          if (type == EosTarget::EOS_TARGET_CUE)
-          {
-            if (cmd.path.size() > replyPath.size())
-            {
-              std::string listStr(cmd.path, replyPath.size() + 1);
-              const char *s = listStr.c_str();
-              if (s)
-                listId = atoi(s);
-            }
-
-            if (listId < 1)
-              break;  // invalid list id
-          }
-
-          TARGETLIST_DATA::iterator j = targetData.find(listId);
-          if (j != targetData.end())
-          {
-            EosTargetList *targetList = j->second;
-            targetList->Recv(tcp, osc, log, cmd);
-            m_Status.UpdateFromChild(targetList->GetStatus());
-            if (type == EosTarget::EOS_TARGET_CUELIST)
-              RemoveOrphanedCues();
-            found = true;
-          }
-
-          // done
-          break;
+          EosTargetList *targetList = j->second;
+          targetList->Recv(tcp, osc, log, cmd, route.offset);
+          m_Status.UpdateFromChild(targetList->GetStatus());
+          if (route.type == EosTarget::EOS_TARGET_CUELIST)
+            RemoveOrphanedCues(showData);
+          found = true;
         }
       }
 
@@ -1371,67 +3214,46 @@ void EosSyncData::RecvCmd(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sComman
     }
     else
     {
-      std::string text("ignored unsolicited reply \"");
-      text.append(cmd.path);
-      text.append("\"");
-      log.AddInfo(text);
+      if (log.IsEnabled(EosLog::LOG_MSG_TYPE_INFO))
+      {
+        std::string text("ignored unsolicited reply \"");
+        text.append(cmd.path);
+        text.append("\"");
+        log.AddInfo(text);
+      }
     }
   }
   else if (m_Status.GetValue() != EosSyncStatus::SYNC_STATUS_UNINTIALIZED)
   {
     // is it a notification about show data changes?
-    static const std::string sNotify("/eos/out/notify/");
-    if (cmd.path.find(sNotify) == 0)
-    {
-      // route to proper target
-      bool found = false;
-      for (SHOW_DATA::iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
-      {
-        TARGETLIST_DATA &targetData = i->second;
-        EosTarget::EnumEosTargetType type = i->first;
-        std::string notifyPath(sNotify);
-        notifyPath.append(EosTarget::GetNameForTargetType(type));
-        if (cmd.path.find(notifyPath) == 0)
-        {
-          // found the matching target
-
-          // get listId when applicable
-          int listId = 0;
-          if (type == EosTarget::EOS_TARGET_CUE)
-          {
-            if (cmd.path.size() > notifyPath.size())
-            {
-              std::string listStr(cmd.path, notifyPath.size() + 1);
-              const char *s = listStr.c_str();
-              if (s)
-                listId = atoi(s);
-            }
-
-            if (listId < 1)
-              break;  // invalid list id
-          }
-
-          TARGETLIST_DATA::iterator j = targetData.find(listId);
-          EosTargetList *targetList = ((j == targetData.end()) ? 0 : j->second);
-
-          // target list does not exist
-          if (!targetList && type == EosTarget::EOS_TARGET_CUE)
-          {
-            // new cue list created, add placeholder cue
-            targetList = new EosTargetList(EosTarget::EOS_TARGET_CUE, listId);
-            targetList->InitializeAsDummy();
-            targetData[listId] = targetList;
-          }
+    if (route.routeType == ROUTE_NOTIFY)
+    {
+      // route to proper target
+      bool found = false;
+      SHOW_DATA &showData = GetSyncShowData(route.type, route.listId);
+      SHOW_DATA::iterator i = showData.find(route.type);
+      if (i != showData.end())
+      {
+        TARGETLIST_DATA &targetData = i->second;
+        TARGETLIST_DATA::iterator j = targetData.find(route.listId);
+        EosTargetList *targetList = ((j == targetData.end()) ? 0 : j->second);
 
-          if (targetList)
-          {
-            targetList->Notify(log, cmd);
-            m_Status.UpdateFromChild(targetList->GetStatus());
-            found = true;
-          }
+        // target list does not exist
+        if (!targetList && route.type == EosTarget::EOS_TARGET_CUE)
+        {
+          // new cue list created, add placeholder cue
+          targetList = NewTargetList(EosTarget::EOS_TARGET_CUE, route.listId, /*shadow*/ (&showData == &m_Resync));
+          targetList->InitializeAsDummy();
+          targetData[route.listId] = targetList;
+        }
 
-          // done
-          break;
+        if (targetList)
+        {
+          targetList->Notify(log, cmd);
+          if (targetList->TakeResyncRequest())
+            StartResync(log, *targetList);
+          m_Status.UpdateFromChild(targetList->GetStatus());
+          found = true;
         }
       }
 
@@ -1448,17 +3270,13 @@ void EosSyncData::RecvCmd(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sComman
       static const std::string sShowLoaded("/eos/out/event/show/loaded");
       if (cmd.path.find(sShowLoaded) == 0)
       {
-        log.AddInfo("reset sync data, new show loaded");
-        Clear();
+        ResetShow(log, /*loaded*/ true);
       }
       else
       {
         static const std::string sShowCleared("/eos/out/event/show/cleared");
         if (cmd.path.find(sShowCleared) == 0)
-        {
-          log.AddInfo("reset sync data, show cleared");
-          Clear();
-        }
+          ResetShow(log, /*loaded*/ false);
       }
     }
   }
@@ -1466,10 +3284,78 @@ void EosSyncData::RecvCmd(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sComman
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void EosSyncData::RemoveOrphanedCues()
+bool EosSyncData::GetRoute(const std::string &path, sRoute &route)
+{
+  // /eos/out/{get|notify}/<type>[/<listId>]..., resolved in place in a single pass
+  route = sRoute();
+
+  const char *s = path.c_str();
+  size_t size = path.size();
+
+  static const char sOut[] = "/eos/out/";
+  static const size_t sOutLen = (sizeof(sOut) - 1);
+  if (size < sOutLen || memcmp(s, sOut, sOutLen) != 0)
+    return false;
+
+  size_t i = sOutLen;
+  EnumRouteType routeType = ROUTE_INVALID;
+  if ((size - i) > 4 && memcmp(&s[i], "get/", 4) == 0)
+  {
+    routeType = ROUTE_GET_REPLY;
+    i += 4;
+  }
+  else if ((size - i) > 7 && memcmp(&s[i], "notify/", 7) == 0)
+  {
+    routeType = ROUTE_NOTIFY;
+    i += 7;
+  }
+  else
+    return false;
+
+  // type
+  const char *name = &s[i];
+  const char *separator = static_cast<const char *>(memchr(name, OSC_ADDR_SEPARATOR, size - i));
+  size_t len = (separator ? static_cast<size_t>(separator - name) : (size - i));
+  EosTarget::EnumEosTargetType type = EosTarget::GetTargetTypeForName(name, len);
+  if (type == EosTarget::EOS_TARGET_INVALID)
+    return false;
+  i += len;
+
+  // list id
+  int listId = 0;
+  if (type == EosTarget::EOS_TARGET_CUE)
+  {
+    if (i == size)
+      return false;  // missing list id
+
+    int64_t n = 0;
+    size_t digits = 0;
+    for (i++; i < size && s[i] >= '0' && s[i] <= '9'; i++, digits++)
+    {
+      n = ((n * 10) + (s[i] - '0'));
+      if (n > INT_MAX)
+        return false;
+    }
+
+    if (digits == 0 || n < 1 || (i < size && s[i] != OSC_ADDR_SEPARATOR))
+      return false;  // invalid list id
+
+    listId = static_cast<int>(n);
+  }
+
+  route.routeType = routeType;
+  route.type = type;
+  route.listId = listId;
+  route.offset = i;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::RemoveOrphanedCues(SHOW_DATA &showData)
 {
-  SHOW_DATA::const_iterator showDataConstIter = m_ShowData.find(EosTarget::EOS_TARGET_CUELIST);
-  const TARGETLIST_DATA *cueListList = ((showDataConstIter == m_ShowData.end()) ? 0 : (&showDataConstIter->second));
+  SHOW_DATA::const_iterator showDataConstIter = showData.find(EosTarget::EOS_TARGET_CUELIST);
+  const TARGETLIST_DATA *cueListList = ((showDataConstIter == showData.end()) ? 0 : (&showDataConstIter->second));
   if (cueListList)
   {
     TARGETLIST_DATA::const_iterator targetListConstIter = cueListList->find(0);
@@ -1478,8 +3364,8 @@ void EosSyncData::RemoveOrphanedCues()
     {
       const EosTargetList::TARGETS &cueListTargets = cueList->GetTargets();
 
-      SHOW_DATA::iterator showDataIter = m_ShowData.find(EosTarget::EOS_TARGET_CUE);
-      TARGETLIST_DATA *cues = ((showDataIter == m_ShowData.end()) ? 0 : (&showDataIter->second));
+      SHOW_DATA::iterator showDataIter = showData.find(EosTarget::EOS_TARGET_CUE);
+      TARGETLIST_DATA *cues = ((showDataIter == showData.end()) ? 0 : (&showDataIter->second));
       if (cues)
       {
         for (TARGETLIST_DATA::iterator i = cues->begin(); i != cues->end();)
@@ -1489,7 +3375,7 @@ void EosSyncData::RemoveOrphanedCues()
           {
             if (cueListTargets.find(listId) == cueListTargets.end())
             {
-              delete i->second;
+              DeleteTargetList(i->second, /*shadow*/ (&showData == &m_Resync));
               TARGETLIST_DATA::iterator eraseMe = i++;
               cues->erase(eraseMe);
             }
@@ -1516,6 +3402,301 @@ void EosSyncData::Tick(EosTcp &tcp, EosOsc &osc, EosLog &log)
   }
 
   Recv(tcp, osc, log);
+
+  if (m_DataSnapshotsEnabled)
+    PublishDataSnapshot();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetList *EosSyncData::NewTargetList(EosTarget::EnumEosTargetType type, int listId, bool shadow)
+{
+  EosTargetList *targetList = 0;
+  if (shadow)
+  {
+    // detached from journal and indexes until swapped in
+    targetList = new EosTargetList(type, listId, m_PropertyStorage, &m_StringPool, m_Memory);
+  }
+  else
+  {
+    m_Journal.Add(EosChangeJournal::CHANGE_LIST_ADDED, type, listId);
+    targetList = new EosTargetList(type, listId, m_PropertyStorage, &m_StringPool, m_Memory, &m_Journal, &m_ChannelIndex, &m_PatchIndex, &m_LabelIndex);
+  }
+  targetList->SetRefetchWindow(m_RefetchWindow);
+  targetList->SetResyncMode(m_ResyncMode);
+  return targetList;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::DeleteTargetList(EosTargetList *targetList, bool shadow)
+{
+  if (!shadow)
+    m_Journal.Add(EosChangeJournal::CHANGE_LIST_REMOVED, targetList->GetType(), targetList->GetListId());
+  delete targetList;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosSyncData::SHOW_DATA &EosSyncData::GetSyncShowData(EosTarget::EnumEosTargetType type, int listId)
+{
+  if (m_ResyncShow)
+    return m_Resync;
+
+  SHOW_DATA::const_iterator i = m_Resync.find(type);
+  if (i != m_Resync.end() && i->second.find(listId) != i->second.end())
+    return m_Resync;
+
+  return m_ShowData;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosSyncData::IsInitialSyncComplete(const SHOW_DATA &showData)
+{
+  if (showData.empty())
+    return false;
+
+  for (SHOW_DATA::const_iterator i = showData.begin(); i != showData.end(); i++)
+  {
+    const TARGETLIST_DATA &targetListData = i->second;
+    for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+    {
+      if (!j->second->GetInitialSync().complete)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::ResetShow(EosLog &log, bool loaded)
+{
+  // keep serving the last complete show until the new one is synced,
+  // or the show that was being replaced when reset again
+  if (m_ResyncMode == EosTargetList::RESYNC_SHADOW && (m_ResyncShow || IsInitialSyncComplete(m_ShowData)))
+  {
+    log.AddInfo(loaded ? "resync show data, new show loaded" : "resync show data, show cleared");
+    ClearResync();
+    InitializeShowData(m_Resync);
+    m_ResyncShow = true;
+    m_ResyncShowLoaded = loaded;
+    m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+  }
+  else
+  {
+    log.AddInfo(loaded ? "reset sync data, new show loaded" : "reset sync data, show cleared");
+    Clear();
+    if (loaded)
+      m_Journal.Add(EosChangeJournal::CHANGE_SHOW_LOADED, EosTarget::EOS_TARGET_INVALID, 0);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::StartResync(EosLog &log, EosTargetList &targetList)
+{
+  EosTarget::EnumEosTargetType type = targetList.GetType();
+  int listId = targetList.GetListId();
+
+  if (&GetSyncShowData(type, listId) == &m_Resync)
+  {
+    // not swapped in yet, nothing to keep
+    targetList.Clear();
+  }
+  else
+  {
+    std::string text("resync \"");
+    text.append(targetList.GetGetPath());
+    text.append("\", serving previous data until complete");
+    log.AddInfo(text);
+    m_Resync[type][listId] = NewTargetList(type, listId, /*shadow*/ true);
+  }
+
+  m_Status.SetValue(EosSyncStatus::SYNC_STATUS_RUNNING);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::SwapResync(EosLog &log)
+{
+  if (m_ResyncShow)
+  {
+    m_Journal.Add(EosChangeJournal::CHANGE_SHOW_CLEARED, EosTarget::EOS_TARGET_INVALID, 0);
+    ClearShowData(m_ShowData);
+    m_ShowData.swap(m_Resync);
+
+    for (SHOW_DATA::const_iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
+    {
+      const TARGETLIST_DATA &targetListData = i->second;
+      for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+      {
+        m_Journal.Add(EosChangeJournal::CHANGE_LIST_ADDED, i->first, j->first);
+        j->second->Attach(&m_Journal, &m_ChannelIndex, &m_PatchIndex, &m_LabelIndex);
+      }
+    }
+
+    if (m_ResyncShowLoaded)
+      m_Journal.Add(EosChangeJournal::CHANGE_SHOW_LOADED, EosTarget::EOS_TARGET_INVALID, 0);
+
+    log.AddInfo("resync show data complete");
+  }
+  else
+  {
+    for (SHOW_DATA::const_iterator i = m_Resync.begin(); i != m_Resync.end(); i++)
+    {
+      const TARGETLIST_DATA &targetListData = i->second;
+      for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+      {
+        // previous list leaves the indexes before the new one is added
+        EosTargetList *&targetList = m_ShowData[i->first][j->first];
+        if (targetList)
+        {
+          delete targetList;
+          m_Journal.Add(EosChangeJournal::CHANGE_LIST_RESET, i->first, j->first);
+        }
+        else
+          m_Journal.Add(EosChangeJournal::CHANGE_LIST_ADDED, i->first, j->first);
+
+        targetList = j->second;
+        targetList->Attach(&m_Journal, &m_ChannelIndex, &m_PatchIndex, &m_LabelIndex);
+      }
+    }
+
+    RemoveOrphanedCues(m_ShowData);
+    log.AddInfo("resync complete");
+  }
+
+  m_Resync.clear();
+  m_ResyncShow = false;
+  m_ResyncShowLoaded = false;
+  m_Status.SetDirty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::ClearResync()
+{
+  ClearShowData(m_Resync);
+  m_ResyncShow = false;
+  m_ResyncShowLoaded = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::PublishDataSnapshot()
+{
+  const EosDataSnapshot *prev = m_DataSnapshots->GetLatest();
+  EosDataSnapshot *snapshot = EosDataSnapshot::Create(*this, prev, m_DataSnapshotVersion + 1);
+  if (prev && snapshot->IsSameAs(*prev))
+  {
+    // nothing changed since last publish
+    delete snapshot;
+  }
+  else
+  {
+    m_DataSnapshotVersion++;
+    m_DataSnapshots->Publish(snapshot);
+  }
+
+  m_DataSnapshots->Reclaim();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::SetDataSnapshotsEnabled(bool enabled)
+{
+  if (m_DataSnapshotsEnabled != enabled)
+  {
+    m_DataSnapshotsEnabled = enabled;
+    if (m_DataSnapshotsEnabled)
+      PublishDataSnapshot();
+    else
+    {
+      m_DataSnapshots->Publish(0);
+      m_DataSnapshots->Reclaim();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::SetLabelIndexEnabled(bool enabled)
+{
+  if (m_LabelIndex.IsEnabled() == enabled)
+    return;
+
+  m_LabelIndex.SetEnabled(enabled);
+  if (!enabled)
+    return;
+
+  // index the targets synced so far, later replies keep it current
+  for (SHOW_DATA::const_iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
+  {
+    const TARGETLIST_DATA &targetListData = i->second;
+    for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+    {
+      EosLabelIndex::sRef ref;
+      ref.type = j->second->GetType();
+      ref.listId = j->second->GetListId();
+
+      const EosTargetList::TARGETS &targets = j->second->GetTargets();
+      for (EosTargetList::TARGETS::const_iterator k = targets.begin(); k != targets.end(); k++)
+      {
+        const EosTargetList::PARTS &parts = k->second.list;
+        for (EosTargetList::PARTS::const_iterator l = parts.begin(); l != parts.end(); l++)
+        {
+          ref.key = EosTarget::sTargetKey(k->first, l->first);
+          m_LabelIndex.Update(ref, *l->second);
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::SetRefetchWindow(unsigned int ms)
+{
+  m_RefetchWindow = ms;
+
+  for (SHOW_DATA::const_iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
+  {
+    const TARGETLIST_DATA &targetListData = i->second;
+    for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+      j->second->SetRefetchWindow(ms);
+  }
+
+  for (SHOW_DATA::const_iterator i = m_Resync.begin(); i != m_Resync.end(); i++)
+  {
+    const TARGETLIST_DATA &targetListData = i->second;
+    for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+      j->second->SetRefetchWindow(ms);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncData::SetResyncMode(EosTargetList::EnumResyncMode mode)
+{
+  m_ResyncMode = mode;
+
+  // a resync already started finishes in the mode it began with
+  for (SHOW_DATA::const_iterator i = m_ShowData.begin(); i != m_ShowData.end(); i++)
+  {
+    const TARGETLIST_DATA &targetListData = i->second;
+    for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+      j->second->SetResyncMode(mode);
+  }
+
+  for (SHOW_DATA::const_iterator i = m_Resync.begin(); i != m_Resync.end(); i++)
+  {
+    const TARGETLIST_DATA &targetListData = i->second;
+    for (TARGETLIST_DATA::const_iterator j = targetListData.begin(); j != targetListData.end(); j++)
+      j->second->SetResyncMode(mode);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1544,10 +3725,22 @@ void EosSyncData::SetSubscribedTypes(const EosTarget::TYPE_LIST &list)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosSyncLib::EosSyncLib()
+void EosSyncData::SetPropertyStorage(EosTargetList::EnumPropertyStorage storage)
+{
+  if (m_PropertyStorage != storage)
+  {
+    Clear();
+    m_PropertyStorage = storage;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosSyncLib::EosSyncLib(EosMemoryResource *memory)
+  : m_Data(memory)
 {
   m_Tcp = EosTcp::Create();
-  m_Osc = new EosOsc(m_Log);
+  m_Osc = new EosOsc(m_Log, memory);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1624,8 +3817,94 @@ void EosSyncLib::Tick()
     m_Osc->Tick(*m_Tcp);
   }
 
-  if (m_Log.Size() > MAX_LOG_Q_SIZE_BEFORE_CLEAR)  // Most likely we do not have the client flushing the log
-    m_Log.Clear();
+  if (!m_Listeners.empty())
+    DispatchChanges();
+
+  if (!m_Log.GetRing())  // a ring is bounded and counts its own overflow
+  {
+    size_t logSize = m_Log.Size();
+    if (logSize > MAX_LOG_Q_SIZE_BEFORE_CLEAR)  // Most likely we do not have the client flushing the log
+    {
+      m_Log.Clear();
+      char text[128];
+      sprintf(text, "log overflow, discarded %u messages", static_cast<unsigned int>(logSize));
+      m_Log.AddWarning(text);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncLib::AddListener(EosSyncListener *listener, EosTarget::EnumEosTargetType type, int listId)
+{
+  if (!listener)
+    return;
+
+  sListener entry;
+  entry.listener = listener;
+  entry.type = type;
+  entry.listId = listId;
+  m_Listeners.push_back(entry);
+
+  m_Data.SetChangeBatching(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncLib::RemoveListener(EosSyncListener *listener)
+{
+  for (LISTENERS::iterator i = m_Listeners.begin(); i != m_Listeners.end();)
+  {
+    if (i->listener == listener)
+      i = m_Listeners.erase(i);
+    else
+      i++;
+  }
+
+  if (m_Listeners.empty())
+    m_Data.SetChangeBatching(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosSyncLib::DispatchChanges()
+{
+  m_Data.TakeChangeBatch(m_Changes);
+  if (m_Changes.empty())
+    return;
+
+  // listeners may add or remove listeners from their callback
+  LISTENERS listeners(m_Listeners);
+  for (LISTENERS::const_iterator i = listeners.begin(); i != listeners.end(); i++)
+  {
+    const sListener &entry = *i;
+
+    const EosChangeJournal::CHANGES *changes = &m_Changes;
+    if (entry.type != EosTarget::EOS_TARGET_INVALID || entry.listId != EosSyncListener::ANY_LIST_ID)
+    {
+      m_ListenerChanges.clear();
+      for (EosChangeJournal::CHANGES::const_iterator j = m_Changes.begin(); j != m_Changes.end(); j++)
+      {
+        if (j->type == EosTarget::EOS_TARGET_INVALID ||
+            ((entry.type == EosTarget::EOS_TARGET_INVALID || entry.type == j->type) && (entry.listId == EosSyncListener::ANY_LIST_ID || entry.listId == j->listId)))
+        {
+          m_ListenerChanges.push_back(*j);
+        }
+      }
+      changes = &m_ListenerChanges;
+    }
+
+    if (changes->empty())
+      continue;
+
+    // skip listeners removed by an earlier callback
+    bool registered = false;
+    for (LISTENERS::const_iterator j = m_Listeners.begin(); j != m_Listeners.end() && !registered; j++)
+      registered = (j->listener == entry.listener);
+
+    if (registered)
+      entry.listener->OnSyncChanges(*this, *changes);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1637,6 +3916,13 @@ bool EosSyncLib::Send(OSCPacketWriter &packet, bool immediate)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool EosSyncLib::Send(const OSCPreparedPacket &packet, bool immediate)
+{
+  return (IsConnected() && m_Osc->Send(*m_Tcp, packet, immediate));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 const EosTargetList &EosSyncLib::GetPatch() const
 {
   const EosTargetList *list = m_Data.GetTargetList(EosTarget::EOS_TARGET_PATCH, /*listId*/ 0);
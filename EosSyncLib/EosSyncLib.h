@@ -30,10 +30,26 @@
 #include "EosOsc.h"
 #endif
 
+#ifndef EOS_PROPERTY_COLUMNS_H
+#include "EosPropertyColumns.h"
+#endif
+
+#ifndef EOS_FLAT_MAP_H
+#include "EosFlatMap.h"
+#endif
+
+#ifndef EOS_CHANNEL_SET_H
+#include "EosChannelSet.h"
+#endif
+
 #include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
 
 class EosTcp;
+class EosDataSnapshotManager;
+class EosSyncLib;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -93,6 +109,18 @@ public:
     EOS_TARGET_INVALID
   };
 
+  enum EnumConstants
+  {
+    MAX_PROP_GROUPS = 4,
+
+    PROP_GROUP_GENERAL = 0,
+    PROP_GROUP_INVALID = -1,
+
+    NUMBER_DECIMALS = 3,
+    NUMBER_SCALE = 1000,
+    MAX_NUMBER_STRING_SIZE = 16  // "-2147483647.999"
+  };
+
   typedef std::vector<EnumEosTargetType> TYPE_LIST;
 
   struct sDecimalNumber
@@ -118,32 +146,78 @@ public:
     int decimal;
   };
 
+  // packed fixed-point target number, whole * NUMBER_SCALE + decimal with the sign applied to both
+  // 1.5 is 1500, -0.25 is -250
+  struct sTargetNumber
+  {
+    sTargetNumber()
+      : value(0)
+    {
+    }
+    sTargetNumber(int Whole)
+      : value(static_cast<int64_t>(Whole) * NUMBER_SCALE)
+    {
+    }
+    sTargetNumber(const sDecimalNumber &num);
+    static sTargetNumber FromValue(int64_t Value);
+    bool operator==(const sTargetNumber &other) const { return (value == other.value); }
+    bool operator!=(const sTargetNumber &other) const { return (value != other.value); }
+    bool operator<(const sTargetNumber &other) const { return (value < other.value); }
+    int GetWhole() const { return static_cast<int>(value / NUMBER_SCALE); }
+    int GetDecimal() const;
+    bool IsWhole() const { return ((value % NUMBER_SCALE) == 0); }
+    sDecimalNumber GetDecimalNumber() const { return sDecimalNumber(GetWhole(), GetDecimal()); }
+    int64_t value;
+  };
+
   struct sTargetKey
   {
     sTargetKey()
       : part(0)
     {
     }
-    sTargetKey(const sDecimalNumber &Num, int Part)
+    sTargetKey(const sTargetNumber &Num, int Part)
       : num(Num)
       , part(Part)
     {
     }
     bool operator==(const sTargetKey &other) const;
     bool operator<(const sTargetKey &other) const;
-    bool valid() const { return ((num.whole >= 1) || (num.whole >= 0 && num.decimal > 0)); }
-    sDecimalNumber num;
+    bool valid() const { return (num.value > 0); }
+    sTargetNumber num;
     int part;
   };
 
+  // 128-bit binary form of a target UID, "01234567-89AB-CDEF-0123-456789ABCDEF"
+  struct sUID
+  {
+    sUID()
+      : hi(0)
+      , lo(0)
+    {
+    }
+    bool operator==(const sUID &other) const { return (hi == other.hi && lo == other.lo); }
+    bool operator!=(const sUID &other) const { return !(*this == other); }
+    bool operator<(const sUID &other) const { return ((hi == other.hi) ? (lo < other.lo) : (hi < other.hi)); }
+    bool valid() const { return (hi != 0 || lo != 0); }
+    uint64_t hi;
+    uint64_t lo;
+  };
+
+  struct sUIDHash
+  {
+    size_t operator()(const sUID &uid) const { return static_cast<size_t>(uid.hi ^ (uid.lo * 0x9e3779b97f4a7c15ull)); }
+  };
+
   struct sPathData
   {
     sPathData()
-      : isList(false)
+      : groupSlot(PROP_GROUP_GENERAL)
+      , isList(false)
     {
     }
     sTargetKey key;
-    std::string group;
+    int groupSlot;
     bool isList;
     unsigned int listIndex;
     unsigned int listSize;
@@ -165,51 +239,452 @@ public:
   {
     sPropertyGroup()
       : initialized(false)
+      , columnCount(0)
     {
     }
     bool initialized;
     PROPS props;
+    size_t columnCount;  // property count when properties are stored in list columns, props is empty
   };
 
-  typedef std::map<std::string, sPropertyGroup> PROP_GROUPS;
+  // property groups of a target type, shared by every target of that type
+  // slot PROP_GROUP_GENERAL is always the general group ""
+  struct sPropGroupSchema
+  {
+    unsigned int count;
+    const char *names[MAX_PROP_GROUPS];
+  };
 
-  EosTarget(EnumEosTargetType type);
+  EosTarget(EnumEosTargetType type, EosPropertyColumns *columns = 0, const sUID &uid = sUID());
+  virtual ~EosTarget();
   virtual void Clear();
+  virtual EnumEosTargetType GetType() const { return m_Type; }
+  virtual const sUID &GetUID() const { return m_UID; }
+  virtual uint64_t GetGeneration() const { return m_Generation; }
+  virtual unsigned int GetRevision() const { return m_Revision; }
+  virtual uint64_t GetVersion() const { return m_Version; }
+  virtual void SetVersion(uint64_t version) { m_Version = version; }
   virtual const EosSyncStatus &GetStatus() const { return m_Status; }
   virtual void Recv(EosLog &log, EosOsc::sCommand &command, const sPathData &pathData);
-  virtual const PROP_GROUPS &GetPropGroups() const { return m_PropGroups; }
+  virtual unsigned int GetNumPropGroups() const { return GetPropGroupSchema(m_Type).count; }
+  virtual const sPropertyGroup *GetPropGroup(unsigned int slot) const;
+  virtual const sPropertyGroup *GetPropGroup(const char *name) const;
+  virtual const char *GetPropGroupName(unsigned int slot) const { return GetPropGroupNameForTargetType(m_Type, slot); }
+  virtual EosPropertyColumns::ROW GetRow() const { return m_Row; }
+  virtual size_t GetNumProps(unsigned int slot) const;
+  virtual bool GetPropInt(unsigned int slot, unsigned int index, int &n) const;
+  virtual bool GetPropDecimal(unsigned int slot, unsigned int index, int64_t &n) const;
+  virtual bool GetPropDouble(unsigned int slot, unsigned int index, double &d) const;
+  virtual bool GetPropString(unsigned int slot, unsigned int index, std::string &str) const;
+  virtual const char *GetPropString(unsigned int slot, unsigned int index) const;  // always set for string arguments, with column storage 0 for int and float arguments, see the std::string overload
+  virtual bool IsPending() const { return (m_NumPendingGroups != 0 || m_NumPendingProps != 0); }
   virtual void ClearDirty();
 
   static const char *GetNameForTargetType(EnumEosTargetType type);
-  static void InitializePropGroupsForTargetType(EnumEosTargetType type, PROP_GROUPS &propGroups);
-  static bool ExtractPathData(const std::string &path, size_t offset, sPathData &pathData);
+  static EnumEosTargetType GetTargetTypeForName(const char *name, size_t len);
+  static uint64_t NewGeneration();
+  static const sPropGroupSchema &GetPropGroupSchema(EnumEosTargetType type);
+  static const char *GetPropGroupNameForTargetType(EnumEosTargetType type, unsigned int slot);
+  static int GetPropGroupSlot(EnumEosTargetType type, const char *name, size_t len);
+  static bool ExtractPathData(EnumEosTargetType type, const std::string &path, size_t offset, sPathData &pathData);
+  static bool GetNumberFromString(const char *str, size_t len, sTargetNumber &num);
+  static size_t GetStringFromNumber(const sTargetNumber &num, char *buf, size_t size);
+  static void GetStringFromNumber(const sTargetNumber &num, std::string &str);
   static bool GetNumberFromString(const std::string &str, sDecimalNumber &num);
   static void GetStringFromNumber(const sDecimalNumber &num, std::string &str);
+  static bool GetUIDFromString(const char *str, size_t len, sUID &uid);
+  static void GetStringFromUID(const sUID &uid, std::string &str);
 
 private:
+  const EnumEosTargetType m_Type;
+  const sUID m_UID;
+  const uint64_t m_Generation;  // unique per target instance
+  unsigned int m_Revision;      // bumped on every change
+  uint64_t m_Version;           // change journal version of the last change
   EosSyncStatus m_Status;
-  PROP_GROUPS m_PropGroups;
+  sPropertyGroup m_PropGroups[MAX_PROP_GROUPS];
+  EosPropertyColumns *m_Columns;
+  EosPropertyColumns::ROW m_Row;
+  unsigned int m_NumPendingGroups;  // property groups not received yet
+  size_t m_NumPendingProps;         // properties of received groups not set yet
+
+  virtual const sProperty *GetProp(unsigned int slot, unsigned int index) const;
+  virtual size_t GetNumPendingProps(unsigned int slot) const;
 
   EosTarget &operator=(const EosTarget &) { return *this; }  // not allowed
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Bounded journal of show data changes. Every change is stamped with the next version.
+// Readers keep the last version they consumed as a cursor and read everything after it;
+// a cursor that fell behind the retained changes must rescan the show data instead.
+class EosChangeJournal
+{
+public:
+  enum EnumConstants
+  {
+    DEFAULT_CAPACITY = 16384
+  };
+
+  enum EnumChangeKind
+  {
+    CHANGE_TARGET_ADDED = 0,
+    CHANGE_TARGET_MODIFIED,
+    CHANGE_TARGET_REMOVED,
+    CHANGE_LIST_ADDED,
+    CHANGE_LIST_REMOVED,
+    CHANGE_LIST_CLEARED,  // every target of the list removed
+    CHANGE_SHOW_CLEARED,  // every list removed
+    CHANGE_SHOW_LOADED,   // new show loaded on the console, follows CHANGE_SHOW_CLEARED
+    CHANGE_LIST_RESET     // every target of the list replaced by a resynced copy
+  };
+
+  struct sChange
+  {
+    uint64_t version;
+    EnumChangeKind kind;
+    EosTarget::EnumEosTargetType type;
+    int listId;
+    EosTarget::sTargetNumber num;  // target changes only
+    int part;                      // target changes only
+    int groupSlot;                 // property group received for added or modified targets, -1 otherwise
+  };
+
+  typedef std::vector<sChange> CHANGES;
+
+  EosChangeJournal(size_t capacity = DEFAULT_CAPACITY);
+  virtual ~EosChangeJournal() {}
+
+  virtual void Clear();
+  virtual uint64_t GetVersion() const { return m_Version; }
+  virtual uint64_t GetOldestVersion() const { return (m_Version + 1 - m_Size); }
+  virtual size_t GetSize() const { return m_Size; }
+  virtual size_t GetCapacity() const { return m_Capacity; }
+  virtual void SetCapacity(size_t capacity);
+  virtual uint64_t Add(EnumChangeKind kind, EosTarget::EnumEosTargetType type, int listId, const EosTarget::sTargetNumber &num = EosTarget::sTargetNumber(), int part = 0,
+                       int groupSlot = -1);
+  virtual bool Read(uint64_t &cursor, CHANGES &changes, size_t maxChanges = 0) const;
+
+  // batch of every change since the last TakeBatch, regardless of capacity
+  virtual bool GetBatching() const { return m_Batching; }
+  virtual void SetBatching(bool batching);
+  virtual void TakeBatch(CHANGES &changes);
+
+private:
+  CHANGES m_Changes;  // ring, change version v at index v % m_Capacity
+  size_t m_Capacity;
+  size_t m_Size;
+  uint64_t m_Version;
+  bool m_Batching;
+  CHANGES m_Batch;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Receives show data changes from EosSyncLib::Tick, one batch per Tick
+class EosSyncListener
+{
+public:
+  enum EnumConstants
+  {
+    ANY_LIST_ID = -1
+  };
+
+  virtual ~EosSyncListener() {}
+
+  // changes matching the listener's filter, in the order they happened
+  // show wide changes (CHANGE_SHOW_CLEARED, CHANGE_SHOW_LOADED) always pass the filter
+  virtual void OnSyncChanges(EosSyncLib &syncLib, const EosChangeJournal::CHANGES &changes) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Reverse index from channel number to the targets whose "channels" property group
+// references it (groups, presets, palettes, pixel maps). Channels are bucketed in blocks
+// of 2^BLOCK_BITS, each block listing the targets with at least one channel in it.
+// Channels above EosChannelSet::MAX_CHANNEL are kept in the set but not indexed.
+class EosChannelIndex
+{
+public:
+  enum EnumConstants
+  {
+    BLOCK_BITS = 6
+  };
+
+  struct sRef
+  {
+    bool operator==(const sRef &other) const { return (type == other.type && listId == other.listId && key == other.key); }
+    bool operator<(const sRef &other) const;
+    EosTarget::EnumEosTargetType type;
+    int listId;
+    EosTarget::sTargetKey key;
+  };
+
+  typedef std::vector<sRef> REFS;
+
+  EosChannelIndex() {}
+  virtual ~EosChannelIndex() {}
+
+  virtual void Clear();
+  virtual void Set(const sRef &ref, const EosChannelSet &channels);
+  virtual void Remove(const sRef &ref);
+  virtual void RemoveList(EosTarget::EnumEosTargetType type, int listId);
+  virtual size_t GetNumTargets() const { return m_Lookup.size(); }
+  virtual const EosChannelSet *GetChannels(const sRef &ref) const;
+  virtual void GetTargets(uint32_t channel, REFS &refs) const;  // sorted, appended to refs
+  virtual void GetListChannels(EosTarget::EnumEosTargetType type, int listId, EosChannelBitmap &channels) const;  // union, added to channels
+
+  static void GetChannelsFromTarget(const EosTarget &target, unsigned int slot, EosChannelSet &channels);
+
+private:
+  struct sEntry
+  {
+    sRef ref;
+    EosChannelSet channels;
+  };
+
+  typedef std::vector<sEntry> ENTRIES;
+  typedef std::vector<uint32_t> ENTRY_LIST;
+  typedef std::vector<ENTRY_LIST> BLOCKS;
+  typedef std::map<sRef, uint32_t> LOOKUP;
+
+  ENTRIES m_Entries;
+  ENTRY_LIST m_FreeEntries;
+  LOOKUP m_Lookup;
+  BLOCKS m_Blocks;  // entries by channel block
+
+  virtual void AddToBlocks(uint32_t entry);
+  virtual void RemoveFromBlocks(uint32_t entry);
+  virtual void RemoveEntry(LOOKUP::iterator i);
+
+  static sRef GetFirstRef(EosTarget::EnumEosTargetType type, int listId);  // sorts before every target of the list
+
+  // not allowed
+  EosChannelIndex(const EosChannelIndex &);
+  EosChannelIndex &operator=(const EosChannelIndex &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// DMX address index of the patch list, keyed by channel (target number) and part.
+// Addresses are absolute and 1 based like Eos reports them: universe u, address a is
+// (u - 1) * 512 + a. Eos does not report footprints, so each part covers the footprint
+// configured for its fixture model, or the default footprint.
+class EosPatchIndex
+{
+public:
+  enum EnumConstants
+  {
+    UNIVERSE_SIZE = 512,
+    DEFAULT_FOOTPRINT = 1,
+    PROP_INDEX_MODEL = 4,   // general property group
+    PROP_INDEX_ADDRESS = 5  // general property group
+  };
+
+  struct sPatch
+  {
+    EosTarget::sTargetKey key;  // channel, part
+    uint32_t address;           // absolute, first slot
+    uint32_t footprint;         // slots
+    uint32_t GetLastAddress() const { return (address + footprint - 1); }
+  };
+
+  typedef std::vector<sPatch> PATCHES;
+  typedef std::vector<std::pair<sPatch, sPatch> > CONFLICTS;
+
+  EosPatchIndex();
+  virtual ~EosPatchIndex() {}
+
+  virtual void Clear();
+  virtual void Set(const EosTarget::sTargetKey &key, uint32_t address, uint32_t footprint);  // address 0 removes
+  virtual void Remove(const EosTarget::sTargetKey &key);
+  virtual void Update(const EosTarget::sTargetKey &key, const EosTarget &target);
+  virtual size_t GetNumPatches() const { return m_Lookup.size(); }
+  virtual const sPatch *GetPatch(const EosTarget::sTargetKey &key) const;
+  virtual void GetPatches(uint32_t address, PATCHES &patches) const;                         // covering address, appended
+  virtual void GetPatches(unsigned int universe, unsigned int address, PATCHES &patches) const;  // covering universe/address, appended
+  virtual void GetOverlapping(uint32_t address, uint32_t count, PATCHES &patches) const;     // any slot in range, appended
+  virtual void GetConflicts(CONFLICTS &conflicts) const;                                    // every overlapping pair, appended
+
+  // footprints apply to parts indexed after they are set, configure before syncing
+  virtual uint32_t GetDefaultFootprint() const { return m_DefaultFootprint; }
+  virtual void SetDefaultFootprint(uint32_t footprint) { m_DefaultFootprint = (footprint ? footprint : 1); }
+  virtual void SetModelFootprint(const std::string &model, uint32_t footprint);
+  virtual uint32_t GetFootprint(const char *model) const;
+
+  static bool ParseAddress(const char *str, uint32_t &address);  // "1025" or "3/1"
+  static uint32_t GetAbsoluteAddress(unsigned int universe, unsigned int address) { return static_cast<uint32_t>(((universe - 1) * UNIVERSE_SIZE) + address); }
+  static unsigned int GetUniverse(uint32_t address) { return (address ? (((address - 1) / UNIVERSE_SIZE) + 1) : 0); }
+  static unsigned int GetUniverseAddress(uint32_t address) { return (address ? (((address - 1) % UNIVERSE_SIZE) + 1) : 0); }
+
+private:
+  typedef std::map<EosTarget::sTargetKey, sPatch> LOOKUP;
+  typedef std::multimap<uint32_t, EosTarget::sTargetKey> BY_ADDRESS;
+  typedef std::map<std::string, uint32_t> FOOTPRINTS;
+
+  LOOKUP m_Lookup;
+  BY_ADDRESS m_ByAddress;
+  uint32_t m_MaxFootprint;  // largest footprint indexed since Clear, bounds interval lookups
+  uint32_t m_DefaultFootprint;
+  FOOTPRINTS m_ModelFootprints;
+
+  // not allowed
+  EosPatchIndex(const EosPatchIndex &);
+  EosPatchIndex &operator=(const EosPatchIndex &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Label search across every target list. Labels are stored case folded (ASCII) and
+// each distinct trigram maps to the targets whose label contains it; a search verifies
+// the targets of the query's rarest trigram only. Queries shorter than a trigram match
+// at word starts only, through grams of the first one and two characters of each word.
+// Results are ranked exact, prefix, word start, then anywhere, shorter labels first.
+// Disabled by default, see EosSyncData::SetLabelIndexEnabled.
+class EosLabelIndex
+{
+public:
+  enum EnumConstants
+  {
+    PROP_INDEX_LABEL = 2,  // general property group
+    TRIGRAM_SIZE = 3
+  };
+
+  enum EnumMatch
+  {
+    MATCH_EXACT = 0,
+    MATCH_PREFIX,
+    MATCH_WORD,  // starts a word after the first
+    MATCH_ANYWHERE,
+
+    MATCH_INVALID
+  };
+
+  typedef EosChannelIndex::sRef sRef;
+
+  struct sResult
+  {
+    sRef ref;
+    EnumMatch match;
+    uint32_t labelSize;
+  };
+
+  typedef std::vector<sResult> RESULTS;
+
+  EosLabelIndex();
+  virtual ~EosLabelIndex() {}
+
+  virtual bool IsEnabled() const { return m_Enabled; }
+  virtual void SetEnabled(bool enabled);  // disabling clears, owner re-populates when enabling
+  virtual void Clear();
+  virtual void Set(const sRef &ref, const char *label);  // empty or null label removes
+  virtual void Remove(const sRef &ref);
+  virtual void RemoveList(EosTarget::EnumEosTargetType type, int listId);
+  virtual void Update(const sRef &ref, const EosTarget &target);
+  virtual size_t GetNumTargets() const { return m_Lookup.size(); }
+  virtual const std::string *GetLabel(const sRef &ref) const;  // case folded
+
+  // best limit matches replace results, type EOS_TARGET_INVALID searches every type
+  virtual void Search(const char *text, size_t limit, RESULTS &results, EosTarget::EnumEosTargetType type = EosTarget::EOS_TARGET_INVALID) const;
+
+  static void FoldCase(const char *str, std::string &folded);
+  static EnumMatch GetMatch(const std::string &label, const std::string &text);  // both folded
+
+private:
+  struct sEntry
+  {
+    sEntry()
+      : stamp(0)
+    {
+    }
+    sRef ref;
+    std::string label;  // folded, empty when unused
+    uint32_t stamp;     // bumped whenever the label changes, older postings are stale
+  };
+
+  struct sPosting
+  {
+    uint32_t entry;
+    uint32_t stamp;
+    uint32_t labelSize;  // lets a search skip labels that cannot rank, without visiting the entry
+  };
+
+  typedef std::vector<sEntry> ENTRIES;
+  typedef std::vector<uint32_t> ENTRY_LIST;
+  typedef std::vector<sPosting> POSTING_LIST;
+  typedef std::vector<uint32_t> GRAMS;
+  typedef std::unordered_map<uint32_t, POSTING_LIST> POSTINGS;
+  typedef std::map<sRef, uint32_t> LOOKUP;
+
+  bool m_Enabled;
+  ENTRIES m_Entries;
+  ENTRY_LIST m_FreeEntries;
+  LOOKUP m_Lookup;
+  POSTINGS m_Postings;  // entries by gram
+  size_t m_NumPostings;
+  size_t m_NumStalePostings;  // left in place on removal, compacted once they outnumber the live ones
+  GRAMS m_Grams;              // scratch
+
+  virtual void AddToPostings(uint32_t entry);
+  virtual void RemoveFromPostings(uint32_t entry);
+  virtual void RemoveEntry(LOOKUP::iterator i);
+  virtual void CompactPostings();
+  virtual bool IsLive(const sPosting &posting) const { return (m_Entries[posting.entry].stamp == posting.stamp); }
+
+  static void GetGrams(const std::string &str, GRAMS &grams);  // trigrams and word start grams, sorted, unique
+  static uint32_t GetTrigram(const char *str);
+  static uint32_t GetWordStartGram(const char *str, size_t size);  // size 1 or 2
+  static bool IsWordChar(char c);
+  static bool IsBetterResult(const sResult &a, const sResult &b);
+
+  // not allowed
+  EosLabelIndex(const EosLabelIndex &);
+  EosLabelIndex &operator=(const EosLabelIndex &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class EosTargetList
 {
 public:
+  enum EnumConstants
+  {
+    DEFAULT_REFETCH_WINDOW = 100  // ms
+  };
+
   struct sInitialSyncInfo
   {
     sInitialSyncInfo()
       : count(0)
       , complete(false)
+      , recountQueued(false)
+      , recountRequested(false)
+      , edited(false)
+      , recountSeq(0)
     {
     }
     size_t count;
     bool complete;
+    bool recountQueued;     // notified during sync, index requests may have shifted
+    bool recountRequested;
+    bool edited;            // notified during sync, answered indexes may have missed shifted targets
+    unsigned int recountSeq;  // /count request that is the recount
+  };
+
+  enum EnumPropertyStorage
+  {
+    PROPERTY_STORAGE_STRINGS = 0,  // EosTarget::sProperty text per property
+    PROPERTY_STORAGE_COLUMNS       // typed per-list columns, see EosPropertyColumns
+  };
+
+  enum EnumResyncMode
+  {
+    RESYNC_CLEAR = 0,  // clear and fetch again, the list is empty until synced
+    RESYNC_SHADOW      // owner syncs a new list alongside this one and swaps it in once complete
   };
 
-  typedef std::map<int, EosTarget *> PARTS;
+  typedef EosFlatMap<int, EosTarget *, 1> PARTS;  // most targets have a single part
 
   struct sParts
   {
@@ -221,39 +696,119 @@ public:
     PARTS list;
   };
 
-  typedef std::map<EosTarget::sDecimalNumber, sParts> TARGETS;
-  typedef std::map<std::string, EosTarget *> UID_LOOKUP;
+  typedef EosFlatMap<EosTarget::sTargetNumber, sParts> TARGETS;
+  typedef std::unordered_map<EosTarget::sUID, EosTarget *, EosTarget::sUIDHash> UID_LOOKUP;
+  typedef std::set<EosTarget::sTargetNumber> TARGET_NUMBERS;
+  typedef std::vector<EosTarget::sTargetNumber> TARGET_NUMBER_LIST;
+  typedef std::vector<std::pair<EosTarget::sTargetNumber, EosTarget::sTargetNumber> > TARGET_NUMBER_RANGES;  // inclusive
 
-  EosTargetList(EosTarget::EnumEosTargetType type, int listId);
+  EosTargetList(EosTarget::EnumEosTargetType type, int listId, EnumPropertyStorage storage = PROPERTY_STORAGE_STRINGS, EosStringPool *stringPool = 0, EosMemoryResource *memory = 0,
+                EosChangeJournal *journal = 0, EosChannelIndex *channelIndex = 0, EosPatchIndex *patchIndex = 0, EosLabelIndex *labelIndex = 0);
   virtual ~EosTargetList();
   virtual void Clear();
   virtual EosTarget::EnumEosTargetType GetType() const { return m_Type; }
   virtual int GetListId() const { return m_ListId; }
+  virtual const std::string &GetGetPath() const { return m_GetPath; }
+  virtual uint64_t GetGeneration() const { return m_Generation; }
+  virtual unsigned int GetRevision() const { return m_Revision; }
+  virtual uint64_t GetVersion() const { return m_Version; }
+  virtual EnumPropertyStorage GetPropertyStorage() const { return (m_Columns ? PROPERTY_STORAGE_COLUMNS : PROPERTY_STORAGE_STRINGS); }
+  virtual const EosPropertyColumns *GetColumns() const { return m_Columns; }
+  virtual const EosPoolResource &GetTargetPool() const { return m_TargetPool; }
   virtual const EosSyncStatus &GetStatus() const { return m_Status; }
   virtual void Tick(EosTcp &tcp, EosOsc &osc);
-  virtual void Recv(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &command);
+  virtual void Recv(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &command, size_t offset);
   virtual void Notify(EosLog &log, EosOsc::sCommand &command);
   virtual void ClearDirty();
   virtual const TARGETS &GetTargets() const { return m_Targets; }
   virtual const UID_LOOKUP &GetUIDLookup() const { return m_UIDLookup; }
+  virtual const EosTarget *GetTargetByUID(const EosTarget::sUID &uid) const;
+  virtual const EosTarget *GetTargetByUID(const std::string &uid) const;
   virtual size_t GetNumTargets() const { return m_NumTargets; }
+  virtual size_t GetNumPendingTargets() const { return (m_Placeholders.size() + m_NumAwaiting); }
+  virtual size_t GetNumRefetches() const { return m_Refetches.size(); }
+  virtual unsigned int GetRefetchWindow() const { return m_RefetchWindow; }
+  virtual void SetRefetchWindow(unsigned int ms) { m_RefetchWindow = ms; }
+  virtual size_t GetNumIncompleteTargets() const { return m_NumIncomplete; }
   virtual const sInitialSyncInfo &GetInitialSync() const { return m_InitialSync; }
+  virtual EnumResyncMode GetResyncMode() const { return m_ResyncMode; }
+  virtual void SetResyncMode(EnumResyncMode mode) { m_ResyncMode = mode; }
+  virtual bool TakeResyncRequest();
+  virtual void Attach(EosChangeJournal *journal, EosChannelIndex *channelIndex, EosPatchIndex *patchIndex, EosLabelIndex *labelIndex);
   virtual void InitializeAsDummy();
 
   static const EosTargetList sm_InvalidTargetList;
 
 private:
+  // changed target that keeps its current parts until the refetched ones are complete
+  struct sRefetch
+  {
+    sRefetch()
+      : due(0)
+      , requested(false)
+      , again(false)
+      , fence(0)
+    {
+    }
+    unsigned int due;  // EosTimer timestamp, notifies before then are coalesced
+    bool requested;    // reply pending
+    bool again;        // notified while requested, the reply may predate the change
+    unsigned int fence;  // /count request sent after the get, its reply follows every part
+    PARTS parts;       // refetched, not visible until swapped in
+  };
+
+  typedef std::map<EosTarget::sTargetNumber, sRefetch> REFETCHES;
+
   const EosTarget::EnumEosTargetType m_Type;
   const int m_ListId;
+  std::string m_GetPath;  // "/eos/get/<type>[/<listId>]"
+  const uint64_t m_Generation;  // unique per list instance
+  unsigned int m_Revision;      // bumped on every change to the list or its targets
+  uint64_t m_Version;           // change journal version of the last change to the list or its targets
+  EosChangeJournal *m_Journal;
+  EosChannelIndex *m_ChannelIndex;
+  int m_ChannelsSlot;  // "channels" property group, -1 if the type has none
+  EosPatchIndex *m_PatchIndex;  // patch list only
+  EosLabelIndex *m_LabelIndex;
+  EosPropertyColumns *m_Columns;
+  EosPoolResource m_TargetPool;  // every EosTarget of the list, released at once by Clear
   TARGETS m_Targets;
   size_t m_NumTargets;
+  TARGET_NUMBERS m_Placeholders;  // uninitialized placeholders, info not requested yet
+  size_t m_NumAwaiting;           // initialized placeholders waiting for a reply
+  size_t m_NumIncomplete;         // targets with status other than SYNC_STATUS_COMPLETE
   UID_LOOKUP m_UIDLookup;
+  REFETCHES m_Refetches;
+  unsigned int m_RefetchWindow;  // ms
+  unsigned int m_NumCountsSent;      // /count requests after the first, replies arrive in request order
+  unsigned int m_NumCountsReceived;
+  bool m_CountFenceQueued;           // refetches requested since the last /count
+  EnumResyncMode m_ResyncMode;
+  bool m_ResyncRequested;  // RESYNC_SHADOW, waiting for the owner to start the new list
   EosSyncStatus m_Status;
   EosSyncStatus m_StatusInternal;  // used for getting target count only
   sInitialSyncInfo m_InitialSync;
 
-  virtual void DeleteTarget(EosTarget *target);
+  virtual EosTarget *NewTarget(const EosTarget::sUID &uid);
+  virtual void DeleteTarget(const EosTarget::sTargetNumber &num, int part, EosTarget *target);
+  virtual void ReleaseTarget(EosTarget *target);
+  virtual void FreeTarget(EosTarget *target);
+  virtual void UpdateChannelIndex(const EosTarget::sTargetNumber &num, int part, const EosTarget &target);
+  virtual EosChannelIndex::sRef GetTargetRef(const EosTarget::sTargetNumber &num, int part) const;
+  virtual void Resync();
+  virtual void InvalidateTarget(TARGETS::iterator i);
+  virtual void AddPlaceholder(const EosTarget::sTargetNumber &num);
+  virtual void QueueRefetch(const EosTarget::sTargetNumber &num);
+  virtual void TickRefetches(EosTcp &tcp, EosOsc &osc);
+  virtual void RecvRecount(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &command);
+  virtual void RequestIndexes(EosTcp &tcp, EosOsc &osc, EosLog &log, size_t first, size_t last);
+  virtual bool RecvRefetch(EosLog &log, EosOsc::sCommand &command, const EosTarget::sPathData &pathData, int part, const EosTarget::sUID &uid);
+  virtual void SwapRefetch(REFETCHES::iterator i);
+  virtual void DropRefetch(const EosTarget::sTargetNumber &num);
   virtual void ProcessReceviedTarget(EosLog &log, EosOsc::sCommand &command, const EosTarget::sPathData &pathData);
+  virtual void AddChange(EosChangeJournal::EnumChangeKind kind, const EosTarget::sTargetNumber &num, int part, EosTarget *target, int groupSlot = -1);
+
+  static bool GetNotifyRange(const OSCArgument &arg, EosTarget::sTargetNumber &first, EosTarget::sTargetNumber &last);  // "12", "1.5" or "1-99999"
 
   EosTargetList &operator=(const EosTargetList &) { return *this; }  // not allowed
 };
@@ -266,7 +821,30 @@ public:
   typedef std::map<int, EosTargetList *> TARGETLIST_DATA;
   typedef std::map<EosTarget::EnumEosTargetType, TARGETLIST_DATA> SHOW_DATA;
 
-  EosSyncData();
+  enum EnumRouteType
+  {
+    ROUTE_GET_REPLY = 0,  // /eos/out/get/<type>[/<listId>]...
+    ROUTE_NOTIFY,         // /eos/out/notify/<type>[/<listId>]...
+
+    ROUTE_INVALID
+  };
+
+  struct sRoute
+  {
+    sRoute()
+      : routeType(ROUTE_INVALID)
+      , type(EosTarget::EOS_TARGET_INVALID)
+      , listId(0)
+      , offset(0)
+    {
+    }
+    EnumRouteType routeType;
+    EosTarget::EnumEosTargetType type;
+    int listId;     // cue list number for EOS_TARGET_CUE, otherwise 0
+    size_t offset;  // path index just past the type and list id, at '/' or the end
+  };
+
+  EosSyncData(EosMemoryResource *memory = 0);
   virtual ~EosSyncData();
 
   virtual void Clear();
@@ -276,18 +854,69 @@ public:
   virtual const EosTargetList *GetTargetList(EosTarget::EnumEosTargetType type, int listId) const;
   virtual void ClearDirty();
   virtual void SetSubscribedTypes(const EosTarget::TYPE_LIST &list);
+  virtual EosTargetList::EnumPropertyStorage GetPropertyStorage() const { return m_PropertyStorage; }
+  virtual void SetPropertyStorage(EosTargetList::EnumPropertyStorage storage);
+  virtual const EosStringPool &GetStringPool() const { return m_StringPool; }
+  virtual EosMemoryResource &GetMemoryResource() const { return *m_Memory; }
+  virtual bool GetDataSnapshotsEnabled() const { return m_DataSnapshotsEnabled; }
+  virtual void SetDataSnapshotsEnabled(bool enabled);
+  virtual EosDataSnapshotManager &GetDataSnapshots() const { return *m_DataSnapshots; }
+  virtual const EosChangeJournal &GetJournal() const { return m_Journal; }
+  virtual void SetJournalCapacity(size_t capacity) { m_Journal.SetCapacity(capacity); }
+  virtual void SetChangeBatching(bool batching) { m_Journal.SetBatching(batching); }
+  virtual const EosChannelIndex &GetChannelIndex() const { return m_ChannelIndex; }
+  virtual const EosPatchIndex &GetPatchIndex() const { return m_PatchIndex; }
+  virtual EosPatchIndex &GetPatchIndex() { return m_PatchIndex; }
+  virtual const EosLabelIndex &GetLabelIndex() const { return m_LabelIndex; }
+  virtual void SetLabelIndexEnabled(bool enabled);
+  virtual unsigned int GetRefetchWindow() const { return m_RefetchWindow; }
+  virtual void SetRefetchWindow(unsigned int ms);
+  virtual EosTargetList::EnumResyncMode GetResyncMode() const { return m_ResyncMode; }
+  virtual void SetResyncMode(EosTargetList::EnumResyncMode mode);
+  virtual bool IsResyncing() const { return !m_Resync.empty(); }
+  virtual void TakeChangeBatch(EosChangeJournal::CHANGES &changes) { m_Journal.TakeBatch(changes); }
+
+  static bool GetRoute(const std::string &path, sRoute &route);
 
 private:
   EosSyncStatus m_Status;
   SHOW_DATA m_ShowData;
   EosTarget::TYPE_LIST m_Types;
+  EosTargetList::EnumPropertyStorage m_PropertyStorage;
+  EosMemoryResource *m_Memory;  // upstream of target pools and the string pool
+  EosStringPool m_StringPool;  // shared by the property columns of every list
+  EosDataSnapshotManager *m_DataSnapshots;
+  bool m_DataSnapshotsEnabled;
+  uint64_t m_DataSnapshotVersion;
+  EosChangeJournal m_Journal;
+  EosChannelIndex m_ChannelIndex;
+  EosPatchIndex m_PatchIndex;
+  EosLabelIndex m_LabelIndex;
+  unsigned int m_RefetchWindow;  // ms
+  EosTargetList::EnumResyncMode m_ResyncMode;
+  SHOW_DATA m_Resync;     // RESYNC_SHADOW, lists syncing alongside m_ShowData, not visible until swapped in
+  bool m_ResyncShow;      // m_Resync replaces the whole show
+  bool m_ResyncShowLoaded;
 
   virtual void Initialize();
+  virtual void InitializeShowData(SHOW_DATA &showData);
   virtual void TickRunning(EosTcp &tcp, EosOsc &osc, EosLog &log);
+  virtual void TickShowData(SHOW_DATA &showData, EosTcp &tcp, EosOsc &osc, bool &allShowDataComplete);
   virtual void Recv(EosTcp &tcp, EosOsc &osc, EosLog &log);
   virtual void RecvCmd(EosTcp &tcp, EosOsc &osc, EosLog &log, EosOsc::sCommand &command);
-  virtual void OnTargeListInitialSyncComplete(EosTargetList &targetList);
-  virtual void RemoveOrphanedCues();
+  virtual void OnTargeListInitialSyncComplete(SHOW_DATA &showData, EosTargetList &targetList);
+  virtual void RemoveOrphanedCues(SHOW_DATA &showData);
+  virtual void PublishDataSnapshot();
+  virtual EosTargetList *NewTargetList(EosTarget::EnumEosTargetType type, int listId, bool shadow = false);
+  virtual void DeleteTargetList(EosTargetList *targetList, bool shadow = false);
+  virtual SHOW_DATA &GetSyncShowData(EosTarget::EnumEosTargetType type, int listId);
+  virtual void ResetShow(EosLog &log, bool loaded);
+  virtual void StartResync(EosLog &log, EosTargetList &targetList);
+  virtual void SwapResync(EosLog &log);
+  virtual void ClearResync();
+
+  static bool IsInitialSyncComplete(const SHOW_DATA &showData);
+  static void ClearShowData(SHOW_DATA &showData);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -302,7 +931,7 @@ public:
     MAX_LOG_Q_SIZE_BEFORE_CLEAR = 10000
   };
 
-  EosSyncLib();
+  EosSyncLib(EosMemoryResource *memory = 0);
   virtual ~EosSyncLib();
 
   virtual bool Initialize(const char *ip, unsigned short port, const EosTarget::TYPE_LIST *list = nullptr);
@@ -315,7 +944,23 @@ public:
   virtual EosLog &GetLog() { return m_Log; }
   virtual const EosSyncData &GetData() const { return m_Data; }
   virtual void ClearDirty() { m_Data.ClearDirty(); }
+  virtual void SetPropertyStorage(EosTargetList::EnumPropertyStorage storage) { m_Data.SetPropertyStorage(storage); }
+  virtual void SetDataSnapshotsEnabled(bool enabled) { m_Data.SetDataSnapshotsEnabled(enabled); }
+  virtual EosDataSnapshotManager &GetDataSnapshots() const { return m_Data.GetDataSnapshots(); }
+  virtual const EosChangeJournal &GetJournal() const { return m_Data.GetJournal(); }
+  virtual void SetJournalCapacity(size_t capacity) { m_Data.SetJournalCapacity(capacity); }
+  virtual const EosChannelIndex &GetChannelIndex() const { return m_Data.GetChannelIndex(); }
+  virtual const EosPatchIndex &GetPatchIndex() const { return m_Data.GetPatchIndex(); }
+  virtual void SetPatchFootprint(uint32_t footprint) { m_Data.GetPatchIndex().SetDefaultFootprint(footprint); }
+  virtual void SetPatchFootprint(const std::string &model, uint32_t footprint) { m_Data.GetPatchIndex().SetModelFootprint(model, footprint); }
+  virtual const EosLabelIndex &GetLabelIndex() const { return m_Data.GetLabelIndex(); }
+  virtual void SetLabelIndexEnabled(bool enabled) { m_Data.SetLabelIndexEnabled(enabled); }
+  virtual void SetRefetchWindow(unsigned int ms) { m_Data.SetRefetchWindow(ms); }
+  virtual void SetResyncMode(EosTargetList::EnumResyncMode mode) { m_Data.SetResyncMode(mode); }
+  virtual void AddListener(EosSyncListener *listener, EosTarget::EnumEosTargetType type = EosTarget::EOS_TARGET_INVALID, int listId = EosSyncListener::ANY_LIST_ID);
+  virtual void RemoveListener(EosSyncListener *listener);
   virtual bool Send(OSCPacketWriter &packet, bool immediate);
+  virtual bool Send(const OSCPreparedPacket &packet, bool immediate);
 
   // convenience
   virtual const EosTargetList &GetPatch() const;
@@ -336,10 +981,24 @@ public:
   virtual const EosTargetList &GetMagicSheets() const;
 
 protected:
+  struct sListener
+  {
+    EosSyncListener *listener;
+    EosTarget::EnumEosTargetType type;  // EOS_TARGET_INVALID for all types
+    int listId;                         // EosSyncListener::ANY_LIST_ID for all lists
+  };
+
+  typedef std::vector<sListener> LISTENERS;
+
   EosLog m_Log;
   EosTcp *m_Tcp;
   EosOsc *m_Osc;
   EosSyncData m_Data;
+  LISTENERS m_Listeners;
+  EosChangeJournal::CHANGES m_Changes;          // batch of the current Tick
+  EosChangeJournal::CHANGES m_ListenerChanges;  // filtered for a single listener
+
+  virtual void DispatchChanges();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,292 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosTargetQuery.h"
+#include <stdlib.h>
+#include <ctype.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery::EosTargetQuery()
+  : m_HasRange(false)
+  , m_HasPart(false)
+  , m_Part(0)
+  , m_Limit(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EosTargetQuery::Clear()
+{
+  m_HasRange = false;
+  m_HasPart = false;
+  m_Limit = 0;
+  m_Predicates.clear();
+  m_Fields.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery &EosTargetQuery::SetRange(const EosTarget::sTargetNumber &first, const EosTarget::sTargetNumber &last)
+{
+  m_HasRange = true;
+  m_First = first;
+  m_Last = last;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery &EosTargetQuery::SetPart(int part)
+{
+  m_HasPart = true;
+  m_Part = part;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery &EosTargetQuery::SetLimit(size_t limit)
+{
+  m_Limit = limit;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery &EosTargetQuery::Where(unsigned int slot, unsigned int index, EnumOperator op)
+{
+  sPredicate predicate;
+  predicate.slot = slot;
+  predicate.index = index;
+  predicate.op = op;
+  predicate.isNumber = false;
+  predicate.number = 0;
+  m_Predicates.push_back(predicate);
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery &EosTargetQuery::Where(unsigned int slot, unsigned int index, EnumOperator op, double number)
+{
+  Where(slot, index, op);
+  m_Predicates.back().isNumber = true;
+  m_Predicates.back().number = number;
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery &EosTargetQuery::Where(unsigned int slot, unsigned int index, EnumOperator op, const std::string &text)
+{
+  Where(slot, index, op);
+  std::string &predicateText = m_Predicates.back().text;
+  predicateText = text;
+  if (op == OP_CONTAINS)
+  {
+    for (size_t i = 0; i < predicateText.size(); i++)
+      predicateText[i] = static_cast<char>(tolower(static_cast<unsigned char>(predicateText[i])));
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+EosTargetQuery &EosTargetQuery::Select(unsigned int slot, unsigned int index)
+{
+  sField field;
+  field.slot = slot;
+  field.index = index;
+  m_Fields.push_back(field);
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosTargetQuery::Run(const EosTargetList &targetList, ROWS &rows) const
+{
+  size_t count = 0;
+  if (m_HasRange && m_Last < m_First)
+    return count;
+
+  const EosTargetList::TARGETS &targets = targetList.GetTargets();
+  EosTargetList::TARGETS::const_iterator i = (m_HasRange ? targets.lower_bound(m_First) : targets.begin());
+  EosTargetList::TARGETS::const_iterator end = (m_HasRange ? targets.upper_bound(m_Last) : targets.end());
+  for (; i != end; i++)
+  {
+    const EosTargetList::PARTS &parts = i->second.list;
+    for (EosTargetList::PARTS::const_iterator j = parts.begin(); j != parts.end(); j++)
+    {
+      if (m_HasPart && j->first != m_Part)
+        continue;
+
+      const EosTarget *target = j->second;
+      if (target && Matches(*target))
+      {
+        sRow row;
+        row.key = EosTarget::sTargetKey(i->first, j->first);
+        row.target = target;
+        rows.push_back(row);
+
+        if (++count == m_Limit)
+          return count;
+      }
+    }
+  }
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t EosTargetQuery::Run(const EosSyncData &data, EosTarget::EnumEosTargetType type, int listId, ROWS &rows) const
+{
+  const EosTargetList *targetList = data.GetTargetList(type, listId);
+  return (targetList ? Run(*targetList, rows) : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTargetQuery::Matches(const EosTarget &target) const
+{
+  for (PREDICATES::const_iterator i = m_Predicates.begin(); i != m_Predicates.end(); i++)
+  {
+    if (!Matches(target, *i))
+      return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTargetQuery::GetValue(const sRow &row, size_t field, sValue &value) const
+{
+  value = sValue();
+  if (!row.target || field >= m_Fields.size())
+    return false;
+
+  return GetValue(*row.target, m_Fields[field].slot, m_Fields[field].index, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTargetQuery::GetValue(const EosTarget &target, unsigned int slot, unsigned int index, sValue &value)
+{
+  value = sValue();
+  value.hasNumber = target.GetPropDouble(slot, index, value.number);
+  value.str = target.GetPropString(slot, index);
+  return (value.hasNumber || value.str);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTargetQuery::ContainsNoCase(const char *str, const std::string &lowerText)
+{
+  if (lowerText.empty())
+    return true;
+  if (!str)
+    return false;
+
+  for (; *str; str++)
+  {
+    size_t i = 0;
+    while (i < lowerText.size() && str[i] && tolower(static_cast<unsigned char>(str[i])) == static_cast<unsigned char>(lowerText[i]))
+      i++;
+    if (i == lowerText.size())
+      return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EosTargetQuery::Matches(const EosTarget &target, const sPredicate &predicate) const
+{
+  switch (predicate.op)
+  {
+    case OP_SET:
+    case OP_EMPTY:
+    {
+      sValue value;
+      bool isSet = (GetValue(target, predicate.slot, predicate.index, value) && (value.hasNumber || (value.str && *value.str)));
+      return ((predicate.op == OP_SET) ? isSet : !isSet);
+    }
+
+    case OP_EQUAL:
+    case OP_NOT_EQUAL:
+    {
+      bool equal;
+      if (predicate.isNumber)
+      {
+        double d = 0;
+        equal = (target.GetPropDouble(predicate.slot, predicate.index, d) && d == predicate.number);
+      }
+      else
+      {
+        const char *str = target.GetPropString(predicate.slot, predicate.index);
+        if (str)
+          equal = (predicate.text == str);
+        else
+        {
+          // int or float argument in column storage
+          std::string s;
+          equal = (target.GetPropString(predicate.slot, predicate.index, s) && predicate.text == s);
+        }
+      }
+      return ((predicate.op == OP_EQUAL) ? equal : !equal);
+    }
+
+    case OP_LESS:
+    case OP_LESS_EQUAL:
+    case OP_GREATER:
+    case OP_GREATER_EQUAL:
+    {
+      double d = 0;
+      if (!predicate.isNumber || !target.GetPropDouble(predicate.slot, predicate.index, d))
+        return false;
+
+      switch (predicate.op)
+      {
+        case OP_LESS: return (d < predicate.number);
+        case OP_LESS_EQUAL: return (d <= predicate.number);
+        case OP_GREATER: return (d > predicate.number);
+        default: return (d >= predicate.number);
+      }
+    }
+
+    case OP_CONTAINS:
+    {
+      const char *str = target.GetPropString(predicate.slot, predicate.index);
+      if (str)
+        return ContainsNoCase(str, predicate.text);
+
+      std::string s;
+      return (target.GetPropString(predicate.slot, predicate.index, s) && ContainsNoCase(s.c_str(), predicate.text));
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,136 @@
+// Copyright (c) 2015 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef EOS_TARGET_QUERY_H
+#define EOS_TARGET_QUERY_H
+
+#ifndef EOS_SYNC_LIB_H
+#include "EosSyncLib.h"
+#endif
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Reusable query over a synchronized target list: an optional target number range,
+// property predicates (all must match) and projected fields.
+// Ranges seek through the ordered target map; predicates read typed column cells
+// directly when the list uses PROPERTY_STORAGE_COLUMNS. Results point at the
+// targets, nothing is copied, so they are only valid until the next Tick.
+//
+//   EosTargetQuery query;
+//   // cues 10 through 45.5 whose label contains "blue"
+//   query.SetRange(10, EosTarget::sTargetNumber::FromValue(45500)).Where(EosTarget::PROP_GROUP_GENERAL, 2, EosTargetQuery::OP_CONTAINS, "blue");
+//   query.Run(syncLib.GetCue(3), rows);
+class EosTargetQuery
+{
+public:
+  enum EnumOperator
+  {
+    OP_SET = 0,        // property received and not empty
+    OP_EMPTY,          // property missing or empty
+    OP_EQUAL,          // numeric or exact text
+    OP_NOT_EQUAL,      // numeric or exact text
+    OP_LESS,           // numeric
+    OP_LESS_EQUAL,     // numeric
+    OP_GREATER,        // numeric
+    OP_GREATER_EQUAL,  // numeric
+    OP_CONTAINS        // text, ASCII case insensitive
+  };
+
+  struct sPredicate
+  {
+    unsigned int slot;
+    unsigned int index;
+    EnumOperator op;
+    bool isNumber;
+    double number;
+    std::string text;  // lower case for OP_CONTAINS
+  };
+
+  struct sField
+  {
+    unsigned int slot;
+    unsigned int index;
+  };
+
+  struct sRow
+  {
+    EosTarget::sTargetKey key;
+    const EosTarget *target;
+  };
+
+  struct sValue
+  {
+    sValue()
+      : str(0)
+      , number(0)
+      , hasNumber(false)
+    {
+    }
+    const char *str;  // 0 for int or float arguments in column storage, valid until the target changes
+    double number;
+    bool hasNumber;
+  };
+
+  typedef std::vector<sPredicate> PREDICATES;
+  typedef std::vector<sField> FIELDS;
+  typedef std::vector<sRow> ROWS;
+
+  EosTargetQuery();
+  virtual ~EosTargetQuery() {}
+
+  virtual void Clear();
+  virtual EosTargetQuery &SetRange(const EosTarget::sTargetNumber &first, const EosTarget::sTargetNumber &last);
+  virtual EosTargetQuery &SetPart(int part);
+  virtual EosTargetQuery &SetLimit(size_t limit);
+  virtual EosTargetQuery &Where(unsigned int slot, unsigned int index, EnumOperator op);
+  virtual EosTargetQuery &Where(unsigned int slot, unsigned int index, EnumOperator op, double number);
+  virtual EosTargetQuery &Where(unsigned int slot, unsigned int index, EnumOperator op, const std::string &text);
+  virtual EosTargetQuery &Select(unsigned int slot, unsigned int index);
+  virtual const PREDICATES &GetPredicates() const { return m_Predicates; }
+  virtual const FIELDS &GetFields() const { return m_Fields; }
+
+  virtual size_t Run(const EosTargetList &targetList, ROWS &rows) const;  // appended to rows, returns number added
+  virtual size_t Run(const EosSyncData &data, EosTarget::EnumEosTargetType type, int listId, ROWS &rows) const;
+  virtual bool Matches(const EosTarget &target) const;
+  virtual bool GetValue(const sRow &row, size_t field, sValue &value) const;
+
+  static bool GetValue(const EosTarget &target, unsigned int slot, unsigned int index, sValue &value);
+  static bool ContainsNoCase(const char *str, const std::string &lowerText);
+
+private:
+  bool m_HasRange;
+  EosTarget::sTargetNumber m_First;
+  EosTarget::sTargetNumber m_Last;
+  bool m_HasPart;
+  int m_Part;
+  size_t m_Limit;  // 0 for no limit
+  PREDICATES m_Predicates;
+  FIELDS m_Fields;
+
+  virtual bool Matches(const EosTarget &target, const sPredicate &predicate) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -2206,6 +2206,222 @@ void OSCBundleWriter::AddPacket(OSCPacketElement *packet)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+OSCPreparedPacket::OSCPreparedPacket()
+  : m_Buf(0)
+  , m_Size(0)
+  , m_Slots(0)
+  , m_SlotCount(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCPreparedPacket::OSCPreparedPacket(const OSCPacketWriter &packet)
+  : m_Buf(0)
+  , m_Size(0)
+  , m_Slots(0)
+  , m_SlotCount(0)
+{
+  Prepare(packet);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCPreparedPacket::~OSCPreparedPacket()
+{
+  Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OSCPreparedPacket::Clear()
+{
+  if (m_Buf)
+  {
+    delete[] m_Buf;
+    m_Buf = 0;
+  }
+
+  if (m_Slots)
+  {
+    delete[] m_Slots;
+    m_Slots = 0;
+  }
+
+  m_Size = 0;
+  m_SlotCount = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCPreparedPacket::Prepare(const OSCPacketWriter &packet)
+{
+  Clear();
+
+  size_t packetSize = packet.ComputeSize();
+  if (packetSize == 0 || packetSize > static_cast<size_t>(INT_MAX))
+    return false;
+
+  m_Size = (FRAME_HEADER_SIZE + packetSize);
+  m_Buf = new char[m_Size];
+  char *packetBuf = &m_Buf[FRAME_HEADER_SIZE];
+  if (!packet.Write(packetBuf, packetSize))
+  {
+    Clear();
+    return false;
+  }
+
+  int32_t header = static_cast<int32_t>(packetSize);
+  memcpy(m_Buf, &header, sizeof(header));
+  OSCArgument::Swap32(m_Buf);
+
+  // locate each argument's type tag and binary data, so they can be patched later
+  size_t argCount = 0xffffffff;
+  OSCArgument *args = OSCArgument::GetArgs(packetBuf, packetSize, argCount);
+  if (args)
+  {
+    size_t tagOffset = (FRAME_HEADER_SIZE + OSCArgument::Get32BitAlignedSize(packet.GetPath().size() + 1) + 1);  // +1 for ',' prefix
+    m_Slots = new sSlot[argCount];
+    m_SlotCount = argCount;
+    for (size_t i = 0; i < argCount; i++)
+    {
+      sSlot &slot = m_Slots[i];
+      slot.type = args[i].GetType();
+      slot.tagOffset = (tagOffset + i);
+      slot.dataOffset = ((args[i].GetRaw() && args[i].GetSize() != 0) ? static_cast<size_t>(args[i].GetRaw() - m_Buf) : 0);
+    }
+    delete[] args;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *OSCPreparedPacket::GetFrame(size_t &size) const
+{
+  size = m_Size;
+  return m_Buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *OSCPreparedPacket::GetPacket(size_t &size) const
+{
+  if (m_Buf)
+  {
+    size = (m_Size - FRAME_HEADER_SIZE);
+    return &m_Buf[FRAME_HEADER_SIZE];
+  }
+
+  size = 0;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCArgument::EnumArgumentTypes OSCPreparedPacket::GetSlotType(size_t slot) const
+{
+  return ((slot < m_SlotCount) ? m_Slots[slot].type : OSCArgument::OSC_TYPE_INVALID);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCPreparedPacket::SetInt32(size_t slot, int32_t n)
+{
+  if (slot < m_SlotCount)
+  {
+    const sSlot &s = m_Slots[slot];
+    if (s.type == OSCArgument::OSC_TYPE_INT32 || s.type == OSCArgument::OSC_TYPE_CHAR)
+    {
+      char *p = &m_Buf[s.dataOffset];
+      memcpy(p, &n, 4);
+      OSCArgument::Swap32(p);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCPreparedPacket::SetInt64(size_t slot, const int64_t &n)
+{
+  if (slot < m_SlotCount)
+  {
+    const sSlot &s = m_Slots[slot];
+    if (s.type == OSCArgument::OSC_TYPE_INT64 || s.type == OSCArgument::OSC_TYPE_TIME)
+    {
+      char *p = &m_Buf[s.dataOffset];
+      memcpy(p, &n, 8);
+      OSCArgument::Swap64(p);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCPreparedPacket::SetFloat32(size_t slot, float f)
+{
+  if (slot < m_SlotCount)
+  {
+    const sSlot &s = m_Slots[slot];
+    if (s.type == OSCArgument::OSC_TYPE_FLOAT32)
+    {
+      char *p = &m_Buf[s.dataOffset];
+      memcpy(p, &f, 4);
+      OSCArgument::Swap32(p);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCPreparedPacket::SetFloat64(size_t slot, const double &d)
+{
+  if (slot < m_SlotCount)
+  {
+    const sSlot &s = m_Slots[slot];
+    if (s.type == OSCArgument::OSC_TYPE_FLOAT64)
+    {
+      char *p = &m_Buf[s.dataOffset];
+      memcpy(p, &d, 8);
+      OSCArgument::Swap64(p);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCPreparedPacket::SetBool(size_t slot, bool b)
+{
+  if (slot < m_SlotCount)
+  {
+    // true/false have no binary data, so patch the type tag instead
+    sSlot &s = m_Slots[slot];
+    if (s.type == OSCArgument::OSC_TYPE_TRUE || s.type == OSCArgument::OSC_TYPE_FALSE)
+    {
+      s.type = (b ? OSCArgument::OSC_TYPE_TRUE : OSCArgument::OSC_TYPE_FALSE);
+      m_Buf[s.tagOffset] = OSCArgument::GetCharFromArgumentType(s.type);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 OSCMethod::OSCMethod() {}
 
 ////////////////////////////////////////////////////////////////////////////////
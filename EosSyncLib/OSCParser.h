@@ -309,6 +309,55 @@ protected:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Serializes a packet once, including the FRAME_MODE_1_0 size header, so that fixed
+// size arguments can be patched in place and the frame sent without re-serializing
+class OSCPreparedPacket
+{
+public:
+  enum EnumConstants
+  {
+    FRAME_HEADER_SIZE = 4  // int32 size
+  };
+
+  OSCPreparedPacket();
+  OSCPreparedPacket(const OSCPacketWriter &packet);
+  virtual ~OSCPreparedPacket();
+
+  virtual bool Prepare(const OSCPacketWriter &packet);
+  virtual void Clear();
+  virtual bool IsValid() const { return (m_Buf != 0); }
+  virtual const char *GetFrame(size_t &size) const;
+  virtual const char *GetPacket(size_t &size) const;
+  virtual size_t GetSlotCount() const { return m_SlotCount; }
+  virtual OSCArgument::EnumArgumentTypes GetSlotType(size_t slot) const;
+
+  bool SetInt32(size_t slot, int32_t n);
+  bool SetInt64(size_t slot, const int64_t &n);
+  bool SetFloat32(size_t slot, float f);
+  bool SetFloat64(size_t slot, const double &d);
+  bool SetBool(size_t slot, bool b);
+
+private:
+  // not allowed
+  OSCPreparedPacket(const OSCPreparedPacket &) {}
+  OSCPreparedPacket &operator=(const OSCPreparedPacket &) { return *this; }
+
+protected:
+  struct sSlot
+  {
+    OSCArgument::EnumArgumentTypes type;
+    size_t tagOffset;
+    size_t dataOffset;
+  };
+
+  char *m_Buf;
+  size_t m_Size;
+  sSlot *m_Slots;
+  size_t m_SlotCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class OSCMethod
 {
 public:
@@ -72,6 +72,13 @@ void PrintSummary(const EosSyncData &syncData)
 				printf("%s:\t%d\n", targetName, static_cast<int>(targetList->GetNumTargets()));
 		}
 	}
+
+	EosStringPool::sStats stats;
+	syncData.GetStringPool().GetStats(stats);
+	if(stats.numStrings != 0)
+	{
+		printf("strings:\t%d unique, %d references, %d bytes saved by interning\n", static_cast<int>(stats.numStrings), static_cast<int>(stats.numReferences), static_cast<int>(stats.GetSavedBytes()));
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,6 +90,7 @@ int main(int /*argc*/, char** /*argv*/)
 	printf("Connecting...\n");
 
 	EosSyncLib eosSyncLib;
+	eosSyncLib.GetLog().SetMinLevel(EosLog::LOG_MSG_TYPE_WARNING);	// only warnings & errors are printed below
 	if( eosSyncLib.Initialize("127.0.0.1",EosSyncLib::DEFAULT_PORT) )
 	{
 		bool wasConnected = false;